@@ -3,70 +3,101 @@ author: Meir Yust
 mail: meyu251@gmail.com
 */
 
+#include <algorithm>
 #include <iostream>
-#include <climits>
+#include <limits>
+#include <type_traits>
 #include "Graph.hpp"
+#include "CompressedGraph.hpp"
+#include "VersionedGraph.hpp"
 #include "Algorithms.hpp"
+#include "Instrumentation.hpp"
 
 using namespace std;
 
 namespace graph{
 
-Graph bfs(Graph& g, int root){
+/*
+Every algorithm has a plain version and a version with a Counters policy (see Instrumentation.hpp),
+the plain version runs the instrumented one with NullCounters, so the hooks are compiled out.
+*/
+template <typename G, typename Counters>
+TreeOf<G> bfs(G& g, typename G::vertex_type root, Counters& counters){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
     if(root < 1 || root > g.getNumOfVertices()){
         throw std::invalid_argument("Invalid root.");
     }
 
-    Graph ans(g.getNumOfVertices());
+    counters.phaseBegin("init");
+    TreeOf<G> ans(g.getNumOfVertices());
     DynamicArray<bool> visited(g.getNumOfVertices());
-    for(int i = 0; i < g.getNumOfVertices(); i++){
+    counters.allocation(sizeof(bool) * g.getNumOfVertices());
+    for(V i = 0; i < g.getNumOfVertices(); i++){
         visited.push_back(false);
     }
-    Queue<int> q;
+    Queue<V> q;
+    counters.phaseEnd();
 
+    counters.phaseBegin("search");
     q.enqueue(root);
     visited[root - 1] = true;   // the -1 is becouse the vertex numbered from 1 to n and the array from 0 to n-1
 
     while(!q.isEmpty()){       
-        int current = q.dequeue();
-        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(current);
-        for(int i = 0; i < neighbors.getSize(); i++){
-            int neighbor = neighbors[i].first;
+        V current = q.dequeue();
+        for(const auto& edge : g.neighbors(current)){
+            counters.edgeScanned();
+            V neighbor = edgeTarget(edge);
             if(!visited[neighbor - 1]){
                 q.enqueue(neighbor);
                 visited[neighbor - 1] = true;
-                ans.addDirectedEdge(current, neighbor, neighbors[i].second);    // add also the original weight of this edge
+                ans.addDirectedEdge(current, neighbor, edgeWeight<W>(edge));    // add also the original weight of this edge
             }
         }
     }
+    counters.phaseEnd();
 
     return ans;
 }
 
-Graph dfs(Graph& g, int root){
+template <typename G>
+TreeOf<G> bfs(G& g, typename G::vertex_type root){
+    NullCounters none;
+    return bfs(g, root, none);
+}
+
+template <typename G, typename Counters>
+TreeOf<G> dfs(G& g, typename G::vertex_type root, Counters& counters){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
     if(root < 1 || root > g.getNumOfVertices()){
         throw std::invalid_argument("Invalid root.");
     }
 
-    Graph ans(g.getNumOfVertices());
+    counters.phaseBegin("init");
+    TreeOf<G> ans(g.getNumOfVertices());
     DynamicArray<int> visited(g.getNumOfVertices()); // consider 0 as not visited, 1 as visited but not finished, 2 as visited and finished
-    for(int i = 0; i < g.getNumOfVertices(); i++){
+    counters.allocation(sizeof(int) * g.getNumOfVertices());
+    for(V i = 0; i < g.getNumOfVertices(); i++){
         visited.push_back(0);
     }
-    Stack<int> s;
+    Stack<V> s;
+    counters.phaseEnd();
+
+    counters.phaseBegin("search");
     s.push(root);
     visited[root - 1] = 1;   // the -1 is becouse the vertex numbered from 1 to n and the array from 0 to n-1
 
     while(!s.isEmpty()){
-        int current = s.peek(); // doesn't remove it from the stack yet
-        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(current);
+        V current = s.peek(); // doesn't remove it from the stack yet
         bool allVisited = true;
-        for(int i = 0; i < neighbors.getSize(); i++){
-            int neighbor = neighbors[i].first;
+        for(const auto& edge : g.neighbors(current)){
+            counters.edgeScanned();
+            V neighbor = edgeTarget(edge);
             if(visited[neighbor - 1] == 0){     // only if not visited at all
                 s.push(neighbor);
                 visited[neighbor - 1] = 1;
-                ans.addDirectedEdge(current, neighbor, neighbors[i].second);    // add also the original weight of this edge
+                ans.addDirectedEdge(current, neighbor, edgeWeight<W>(edge));    // add also the original weight of this edge
                 allVisited = false;
                 break;
             }
@@ -76,11 +107,26 @@ Graph dfs(Graph& g, int root){
             s.pop();
         }
     }
+    counters.phaseEnd();
 
     return ans;
 }
 
-Graph dijkstra(Graph& g, int startVertex){
+template <typename G>
+TreeOf<G> dfs(G& g, typename G::vertex_type root){
+    NullCounters none;
+    return dfs(g, root, none);
+}
+
+/*
+The distances are summed in DistanceOf<W> (64 bit for integral weights),
+so long paths don't overflow even when the weights themselves are narrow.
+*/
+template <typename G, typename Counters>
+TreeOf<G> dijkstra(G& g, typename G::vertex_type startVertex, Counters& counters){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    using D = typename DistanceOf<W>::type;
     if(g.hasNegativeEdge()){
         throw std::invalid_argument("Dijkstra's algorithm cannot handle graphs with negative edge weights.");
     }
@@ -88,233 +134,604 @@ Graph dijkstra(Graph& g, int startVertex){
         throw std::invalid_argument("Invalid starting vertex.");
     }
 
-    Graph ans(g.getNumOfVertices());
-    DynamicArray<int> dist(g.getNumOfVertices());
+    counters.phaseBegin("init");
+    TreeOf<G> ans(g.getNumOfVertices());
+    DynamicArray<D> dist(g.getNumOfVertices());
     DynamicArray<bool> visited(g.getNumOfVertices());
-    DynamicArray<int> parents(g.getNumOfVertices());
-    for(int i = 0; i < g.getNumOfVertices(); i++){
-        dist.push_back(INT_MAX);
+    DynamicArray<V> parents(g.getNumOfVertices());
+    DynamicArray<W> parentWeight(g.getNumOfVertices());  // the weight of the edge from the parent
+    counters.allocation((sizeof(D) + sizeof(bool) + sizeof(V) + sizeof(W)) * g.getNumOfVertices());
+    for(V i = 0; i < g.getNumOfVertices(); i++){
+        dist.push_back(std::numeric_limits<D>::max());
         visited.push_back(false);
-        parents.push_back(-1);   // -1 means no parent
+        parents.push_back(0);   // 0 means no parent (the vertices are numbered from 1)
+        parentWeight.push_back(W(0));
     }
+    counters.phaseEnd();
 
+    counters.phaseBegin("search");
     dist[startVertex - 1] = 0;   // the -1 is becouse the vertex numbered from 1 to n and the array from 0 to n-1
-    PriorityQueue<Pair<int, int>> pq;   // the first is the vertex and the second is the distance
+    PriorityQueue<Pair<V, D>, LessBySecond> pq;   // the first is the vertex and the second is the distance
     pq.enqueue({startVertex, 0});
+    counters.heapPush();
 
     while(!pq.isEmpty()){
-        Pair<int, int> current = pq.peek();
-        pq.dequeue();
-        int currentVertex = current.first;
-        int currentDist = current.second;  
-        if(visited[currentVertex - 1]) continue; // already visited
-        visited[currentVertex - 1] = true;
-
-        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(currentVertex);
-        for(int i = 0; i < neighbors.getSize(); i++){
-            int neighbor = neighbors[i].first;
-            int weight = neighbors[i].second;
-            
-            if(!visited[neighbor - 1] && dist[currentVertex - 1] + weight < dist[neighbor - 1]){
-                dist[neighbor - 1] = dist[currentVertex - 1] + weight;
-                parents[neighbor - 1] = currentVertex;
-                pq.enqueue({neighbor, dist[neighbor - 1]});
-            }
+        Pair<V, D> current = pq.dequeue();
+        counters.heapPop();
+        V currentVertex = current.first;
+        if(visited[currentVertex - 1]){     // already visited
+            counters.stalePop();
+            continue;
         }
-    }
-    // build the ans graph
-
-    while(!pq.isEmpty()){
-        Pair<int, int> current = pq.peek();
-        pq.dequeue();
-        int currentVertex = current.first;
-        int currentDist = current.second;  
-        if(visited[currentVertex - 1]) continue; // already visited
         visited[currentVertex - 1] = true;
 
-        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(currentVertex);
-        for(int i = 0; i < neighbors.getSize(); i++){
-            int neighbor = neighbors[i].first;
-            int weight = neighbors[i].second;
+        for(const auto& edge : g.neighbors(currentVertex)){
+            counters.edgeScanned();
+            V neighbor = edgeTarget(edge);
+            W weight = edgeWeight<W>(edge);
+            D newDist = dist[currentVertex - 1] + (D)weight;
             
-            if(!visited[neighbor - 1] && dist[currentVertex - 1] + weight < dist[neighbor - 1]){
-                dist[neighbor - 1] = dist[currentVertex - 1] + weight;
+            if(!visited[neighbor - 1] && newDist < dist[neighbor - 1]){
+                dist[neighbor - 1] = newDist;
                 parents[neighbor - 1] = currentVertex;
-                pq.enqueue({neighbor, dist[neighbor - 1]});
+                parentWeight[neighbor - 1] = weight;
+                pq.enqueue({neighbor, newDist});
+                counters.relaxation();
+                counters.heapPush();
             }
         }
     }
+    counters.phaseEnd();
 
     // build the ans graph
-    for(int i = 0; i < parents.getSize(); i++){
-        if(parents[i] != -1){   // if there is a parent
-            int vertex = i + 1;
-            int parent = parents[i];
-            DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(parent);
-            for(int j = 0; j < neighbors.getSize(); j++){
-                if(neighbors[j].first == vertex){   // find the weight of the edge
-                    ans.addDirectedEdge(parent, vertex, neighbors[j].second);
-                    break;
-                }
-            }
+    counters.phaseBegin("build tree");
+    for(V i = 0; i < g.getNumOfVertices(); i++){
+        if(parents[i] != 0){   // if there is a parent
+            ans.addDirectedEdge(parents[i], i + 1, parentWeight[i]);
         }
     }
+    counters.phaseEnd();
 
     return ans;
 }
 
-Graph prim(Graph& g){
+template <typename G>
+TreeOf<G> dijkstra(G& g, typename G::vertex_type startVertex){
+    NullCounters none;
+    return dijkstra(g, startVertex, none);
+}
+
+template <typename G, typename Counters>
+TreeOf<G> prim(G& g, Counters& counters){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
     if(g.hasNegativeEdge()){
         throw std::invalid_argument("Prim's algorithm cannot handle graphs with negative edge weights.");
     }
+    if(g.getNumOfVertices() == 0){
+        throw std::invalid_argument("The graph is empty.");
+    }
 
-    Graph mst(g.getNumOfVertices());    // this is the ans Graph
+    counters.phaseBegin("init");
+    TreeOf<G> mst(g.getNumOfVertices());    // this is the ans Graph
     DynamicArray<bool> inMST(g.getNumOfVertices());
-    DynamicArray<int> key(g.getNumOfVertices());
-    DynamicArray<int> parents(g.getNumOfVertices());
+    DynamicArray<W> key(g.getNumOfVertices());
+    DynamicArray<V> parents(g.getNumOfVertices());
+    counters.allocation((sizeof(bool) + sizeof(W) + sizeof(V)) * g.getNumOfVertices());
 
-    for(int i = 0; i < g.getNumOfVertices(); i++){
+    for(V i = 0; i < g.getNumOfVertices(); i++){
         inMST.push_back(false);
-        key.push_back(INT_MAX);
-        parents.push_back(-1);   // -1 means no parent
+        key.push_back(W(0));    // not a key yet while the parent is 0, so every weight (even the max) can be selected
+        parents.push_back(0);   // 0 means no parent (the vertices are numbered from 1)
     }
+    counters.phaseEnd();
     
-    PriorityQueue<Pair<int, int>> pq; // first = vertex, second = key
+    counters.phaseBegin("search");
+    PriorityQueue<Pair<V, W>, LessBySecond> pq; // first = vertex, second = key
     
     // We start from vertex 1
     key[0] = 0;
     pq.enqueue({1, 0});
+    counters.heapPush();
     
     while(!pq.isEmpty()){
-        Pair<int, int> current = pq.dequeue();
-        int currentVertex = current.first;
+        Pair<V, W> current = pq.dequeue();
+        counters.heapPop();
+        V currentVertex = current.first;
         
-        if(inMST[currentVertex - 1]) continue;
+        if(inMST[currentVertex - 1]){
+            counters.stalePop();
+            continue;
+        }
         inMST[currentVertex - 1] = true;
         
         // Add this vertex to the MST (if it's not the starting vertex)
-        if(parents[currentVertex - 1] != -1){
-            // Find the original weight from the graph
-            DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(parents[currentVertex - 1]);
-            for(int i = 0; i < neighbors.getSize(); i++){
-                if(neighbors[i].first == currentVertex){
-                    mst.addDirectedEdge(parents[currentVertex - 1], currentVertex, neighbors[i].second);
-                    break;
-                }
-            }
+        // key holds the weight of the edge from the parent
+        if(parents[currentVertex - 1] != 0){
+            mst.addDirectedEdge(parents[currentVertex - 1], currentVertex, key[currentVertex - 1]);
         }
         
         // Explore neighbors
-        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(currentVertex);
-        for(int i = 0; i < neighbors.getSize(); i++){
-            int v = neighbors[i].first;
-            int weight = neighbors[i].second;
+        for(const auto& edge : g.neighbors(currentVertex)){
+            counters.edgeScanned();
+            V v = edgeTarget(edge);
+            W weight = edgeWeight<W>(edge);
             
-            if(!inMST[v - 1] && weight < key[v - 1]){
+            if(!inMST[v - 1] && (parents[v - 1] == 0 || weight < key[v - 1])){
                 parents[v - 1] = currentVertex;
                 key[v - 1] = weight;
                 pq.enqueue({v, weight});
+                counters.relaxation();
+                counters.heapPush();
             }
         }
     }
+    counters.phaseEnd();
     
     return mst;
 }
 
-// Helper function for quicksort
-template <typename T>
-int partition(DynamicArray<T>& arr, int low, int high){
-    T pivot = arr[high];
-    int i = low - 1;    // Index of smaller element
-    
-    for(int j = low; j < high; j++){
-        // If current element is smaller than the pivot
-        if(arr[j].second < pivot.second){
-            i++;
-            // Swap arr[i] and arr[j]
-            T temp = arr[i];
-            arr[i] = arr[j];
-            arr[j] = temp;
-        }
-    }
-    
-    // Swap arr[i+1] and arr[high] (pivot)
-    T temp = arr[i + 1];
-    arr[i + 1] = arr[high];
-    arr[high] = temp;
-    
-    return i + 1;
+template <typename G>
+TreeOf<G> prim(G& g){
+    NullCounters none;
+    return prim(g, none);
 }
 
-// Recursive quicksort implementation
+// Orders the ((src, dest), weight) edges of kruskal by weight, equal weights by the endpoints,
+// so the order (and the tree) doesn't depend on the order the edges were collected in
 template <typename T>
-void quickSort(DynamicArray<T>& arr, int low, int high){
-    if(low < high){
-        // pi is partitioning index
-        int pi = partition(arr, low, high);
+static bool byWeight(const T& a, const T& b){
+    if(a.second < b.second) return true;
+    if(b.second < a.second) return false;
+    if(a.first.first != b.first.first) return a.first.first < b.first.first;
+    return a.first.second < b.first.second;
+}
+
+// Adds the edges that join two trees to mst, in the order of edges
+template <typename G, typename Counters>
+static void addSpanningEdges(TreeOf<G>& mst, const DynamicArray<Pair<Pair<typename G::vertex_type, typename G::vertex_type>,
+                             typename G::weight_type>>& edges, Counters& counters){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    V numVertices = mst.getNumOfVertices();
+    counters.phaseBegin("union find");
+    DisjointSet<V> ds(numVertices + 1);  // +1 because vertices are 1-indexed
+    counters.allocation((sizeof(V) + sizeof(int)) * (numVertices + 1));     // parents and ranks
+    
+    // Process edges in order of increasing weight
+    for(int i = 0; i < edges.getSize(); i++){
+        V src = edges[i].first.first;
+        V dest = edges[i].first.second;
+        W weight = edges[i].second;
         
-        // Sort elements before and after partition
-        quickSort(arr, low, pi - 1);
-        quickSort(arr, pi + 1, high);
+        // Check if adding this edge creates a cycle
+        counters.findCall();    // isSameSet finds both ends
+        counters.findCall();
+        if(!ds.isSameSet(src, dest)){
+            // Add the edge to MST
+            mst.addDirectedEdge(src, dest, weight);
+            
+            // Union the sets
+            counters.unionCall();
+            ds.unionSets(src, dest);
+        }
     }
+    counters.phaseEnd();
 }
 
-Graph kruskal(Graph& g){
+template <typename G, typename Counters>
+TreeOf<G> kruskal(G& g, Counters& counters){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
     if(g.hasNegativeEdge()){
         throw std::invalid_argument("Kruskal's algorithm cannot handle graphs with negative edge weights.");
     }
 
-    int numVertices = g.getNumOfVertices();
+    V numVertices = g.getNumOfVertices();
     if(numVertices == 0){
         throw std::invalid_argument("The graph is empty.");
     }
     
-    Graph mst(numVertices);
+    TreeOf<G> mst(numVertices);
     
     // Create a dynamic array to store all edges as: ((src, dest), weight)
-    DynamicArray<Pair<Pair<int, int>, int>> edges;
+    DynamicArray<Pair<Pair<V, V>, W>> edges;
     
     // Collect all edges from the graph
-    for(int i = 1; i <= numVertices; i++){
-        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(i);
-        for(int j = 0; j < neighbors.getSize(); j++){
-            int neighbor = neighbors[j].first;
-            int weight = neighbors[j].second;
+    counters.phaseBegin("collect edges");
+    for(V i = 1; i <= numVertices; i++){
+        for(const auto& neighborEdge : g.neighbors(i)){
+            counters.edgeScanned();
+            V neighbor = edgeTarget(neighborEdge);
+            W weight = edgeWeight<W>(neighborEdge);
             
             // To consider each edge only once (when i < neighbor)
             if(i < neighbor){
-                Pair<int, int> edge(i, neighbor);
-                Pair<Pair<int, int>, int> weightedEdge(edge, weight);
+                Pair<V, V> edge(i, neighbor);
+                Pair<Pair<V, V>, W> weightedEdge(edge, weight);
                 edges.push_back(weightedEdge);
             }
         }
     }
     
-    // Sort edges by weight using quicksort
-    if(edges.getSize() > 0){
-        quickSort(edges, 0, edges.getSize() - 1);
-    }
+    counters.allocation(sizeof(Pair<Pair<V, V>, W>) * edges.getCapacity());
+    counters.phaseEnd();
     
-    // Create a disjoint set
-    DisjointSet<int> ds(numVertices + 1);  // +1 because vertices are 1-indexed
+    // Sort edges by weight (introsort, O(E log E) even when most weights are equal);
+    // all the weights of an unweighted graph are 1, so any order is already sorted
+    counters.phaseBegin("sort");
+    if constexpr(!std::is_same<typename G::policy_type, Unweighted>::value){
+        std::sort(edges.begin(), edges.end(), byWeight<Pair<Pair<V, V>, W>>);
+    }
+    counters.phaseEnd();
     
-    // Process edges in order of increasing weight
-    for(int i = 0; i < edges.getSize(); i++){
-        int src = edges[i].first.first;
-        int dest = edges[i].first.second;
-        int weight = edges[i].second;
-        
-        // Check if adding this edge creates a cycle
-        if(!ds.isSameSet(src, dest)){
-            // Add the edge to MST
-            mst.addDirectedEdge(src, dest, weight);
-            
-            // Union the sets
-            ds.unionSets(src, dest);
+    addSpanningEdges<G>(mst, edges, counters);
+    return mst;
+}
+
+template <typename G>
+TreeOf<G> kruskal(G& g){
+    NullCounters none;
+    return kruskal(g, none);
+}
+
+/*
+Sorts items on the pool: fixed runs are sorted in parallel, then neighboring runs are merged
+in rounds (the merges of a round run in parallel) through one buffer of the same size
+*/
+template <typename T, typename Less>
+static void parallelSort(DynamicArray<T>& items, ThreadPool& pool, Less less){
+    const long MIN_RUN = 1 << 14;
+    long size = items.getSize();
+    long run = (size + pool.getNumThreads() * 4 - 1) / (pool.getNumThreads() * 4);
+    if(run < MIN_RUN) run = MIN_RUN;
+    long numRuns = (size + run - 1) / run;
+    T* data = items.begin();
+    pool.parallel_for(0, numRuns, [&](long r){
+        std::sort(data + r * run, data + std::min(size, (r + 1) * run), less);
+    }, 1);
+    if(numRuns <= 1){
+        return;
+    }
+
+    DynamicArray<T> buffer(items);
+    T* from = data;
+    T* to = buffer.begin();
+    for(long width = run; width < size; width *= 2){
+        long pairs = (size + 2 * width - 1) / (2 * width);
+        pool.parallel_for(0, pairs, [&](long p){
+            long begin = p * 2 * width;
+            long middle = std::min(size, begin + width);
+            long end = std::min(size, begin + 2 * width);
+            std::merge(from + begin, from + middle, from + middle, from + end, to + begin, less);
+        }, 1);
+        std::swap(from, to);
+    }
+    if(from != data){
+        std::copy(from, from + size, data);
+    }
+}
+
+/*
+The same tree as kruskal(g): the edges are collected by blocks of vertices in parallel (counted first, so every
+block writes its own part of the array, in the order of the sequential collection) and sorted on the pool;
+the union find pass stays sequential, it is a small part of the time
+*/
+template <typename G>
+TreeOf<G> parallelKruskal(G& g, ThreadPool& pool){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    using Edge = Pair<Pair<V, V>, W>;
+    const long BLOCK = 4096;
+    if(g.hasNegativeEdge()){
+        throw std::invalid_argument("Kruskal's algorithm cannot handle graphs with negative edge weights.");
+    }
+    V numVertices = g.getNumOfVertices();
+    if(numVertices == 0){
+        throw std::invalid_argument("The graph is empty.");
+    }
+
+    long n = (long)numVertices;
+    long numBlocks = (n + BLOCK - 1) / BLOCK;
+    DynamicArray<long long> starts((int)numBlocks + 1);
+    for(long b = 0; b <= numBlocks; b++){
+        starts.push_back(0);
+    }
+    long long* start = starts.begin();
+    pool.parallel_for(0, numBlocks, [&](long b){
+        long long count = 0;
+        for(long v = b * BLOCK + 1; v <= std::min(n, (b + 1) * BLOCK); v++){
+            for(const auto& neighborEdge : g.neighbors((V)v)){
+                if((long)edgeTarget(neighborEdge) > v) count++;
+            }
         }
+        start[b + 1] = count;
+    }, 1);
+    for(long b = 0; b < numBlocks; b++){
+        start[b + 1] += start[b];
     }
-    
+
+    DynamicArray<Edge> edges(start[numBlocks] > 0 ? (int)start[numBlocks] : 1);
+    for(long long i = 0; i < start[numBlocks]; i++){
+        edges.push_back(Edge());
+    }
+    Edge* filled = edges.begin();
+    pool.parallel_for(0, numBlocks, [&](long b){
+        long long next = start[b];
+        for(long v = b * BLOCK + 1; v <= std::min(n, (b + 1) * BLOCK); v++){
+            for(const auto& neighborEdge : g.neighbors((V)v)){
+                V neighbor = edgeTarget(neighborEdge);
+                if((long)neighbor > v){
+                    filled[next++] = Edge(Pair<V, V>((V)v, neighbor), edgeWeight<W>(neighborEdge));
+                }
+            }
+        }
+    }, 1);
+
+    // all the weights of an unweighted graph are 1, the collection order is already sorted
+    if constexpr(!std::is_same<typename G::policy_type, Unweighted>::value){
+        parallelSort(edges, pool, byWeight<Edge>);
+    }
+
+    TreeOf<G> mst(numVertices);
+    NullCounters none;
+    addSpanningEdges<G>(mst, edges, none);
     return mst;
 }
 
-} // namespace graph
\ No newline at end of file
+// one empty tree per source, filled by the workers (each index is written by one task only)
+template <typename G, typename Algorithm>
+static DynamicArray<TreeOf<G>> runBatch(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool, Algorithm algorithm){
+    for(int i = 0; i < sources.getSize(); i++){
+        if(sources[i] < 1 || sources[i] > g.getNumOfVertices()){
+            throw std::invalid_argument("Invalid starting vertex.");
+        }
+    }
+    DynamicArray<TreeOf<G>> trees;
+    trees.reserve(sources.getSize());
+    for(int i = 0; i < sources.getSize(); i++){
+        trees.emplace_back(g.getNumOfVertices());
+    }
+    pool.parallel_for(0, sources.getSize(), [&](long i){
+        trees[i] = algorithm(g, sources[i]);
+    }, 1);     // every source is a big unit of work
+    return trees;
+}
+
+template <typename G>
+DynamicArray<TreeOf<G>> bfsBatch(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool){
+    return runBatch(g, sources, pool, [](G& graph, typename G::vertex_type source){
+        return bfs(graph, source);
+    });
+}
+
+template <typename G>
+DynamicArray<TreeOf<G>> dijkstraBatch(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool){
+    if(g.hasNegativeEdge()){
+        throw std::invalid_argument("Dijkstra's algorithm cannot handle graphs with negative edge weights.");
+    }
+    return runBatch(g, sources, pool, [](G& graph, typename G::vertex_type source){
+        return dijkstra(graph, source);
+    });
+}
+
+/*
+One group of at most 64 * Words sources (Then et al., "The More the Merrier: Efficient Multi-Source Graph Traversal").
+seen - the sources that already reached the vertex, visit - the sources that reached it at the current level,
+next - the sources that reach it at the next level. A level scans the edges of every vertex with a non empty visit once
+*/
+template <typename G, int Words>
+static void multiSourceGroup(G& g, const DynamicArray<typename G::vertex_type>& sources, int first, int count,
+                             DynamicArray<DynamicArray<int>>& levels){
+    using V = typename G::vertex_type;
+    long n = (long)g.getNumOfVertices();
+    DynamicArray<uint64_t> seen((int)(n * Words));
+    DynamicArray<uint64_t> visit((int)(n * Words));
+    DynamicArray<uint64_t> next((int)(n * Words));
+    for(long i = 0; i < n * Words; i++){
+        seen.push_back(0);
+        visit.push_back(0);
+        next.push_back(0);
+    }
+    for(int s = 0; s < count; s++){
+        long v = (long)sources[first + s] - 1;
+        uint64_t bit = (uint64_t)1 << (s % 64);
+        seen[v * Words + s / 64] |= bit;
+        visit[v * Words + s / 64] |= bit;
+        levels[first + s][v] = 0;
+    }
+
+    bool active = count > 0;
+    for(int level = 1; active; level++){
+        for(long v = 0; v < n; v++){
+            uint64_t any = 0;
+            for(int w = 0; w < Words; w++){
+                any |= visit[v * Words + w];
+            }
+            if(any == 0) continue;
+            for(const auto& edge : g.neighbors((V)(v + 1))){
+                long u = (long)edgeTarget(edge) - 1;
+                for(int w = 0; w < Words; w++){
+                    next[u * Words + w] |= visit[v * Words + w];
+                }
+            }
+        }
+
+        active = false;
+        for(long u = 0; u < n; u++){
+            for(int w = 0; w < Words; w++){
+                uint64_t reached = next[u * Words + w] & ~seen[u * Words + w];
+                next[u * Words + w] = 0;
+                visit[u * Words + w] = reached;
+                if(reached == 0) continue;
+                seen[u * Words + w] |= reached;
+                active = true;
+                while(reached != 0){
+                    int bit = __builtin_ctzll(reached);
+                    levels[first + w * 64 + bit][u] = level;
+                    reached &= reached - 1;     // clear the lowest bit
+                }
+            }
+        }
+    }
+}
+
+template <typename G, int Words>
+DynamicArray<DynamicArray<int>> multiSourceBfs(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool){
+    static_assert(Words >= 1, "multiSourceBfs needs at least one word per vertex");
+    for(int i = 0; i < sources.getSize(); i++){
+        if(sources[i] < 1 || sources[i] > g.getNumOfVertices()){
+            throw std::invalid_argument("Invalid starting vertex.");
+        }
+    }
+    int n = (int)g.getNumOfVertices();
+    DynamicArray<DynamicArray<int>> levels;
+    levels.reserve(sources.getSize());
+    for(int i = 0; i < sources.getSize(); i++){
+        DynamicArray<int>& sourceLevels = levels.emplace_back(n);
+        for(int v = 0; v < n; v++){
+            sourceLevels.push_back(-1);
+        }
+    }
+    const int groupSize = 64 * Words;
+    long groups = (sources.getSize() + groupSize - 1) / groupSize;
+    pool.parallel_for(0, groups, [&](long group){
+        int first = (int)group * groupSize;
+        int count = sources.getSize() - first < groupSize ? sources.getSize() - first : groupSize;
+        multiSourceGroup<G, Words>(g, sources, first, count, levels);
+    }, 1);
+    return levels;
+}
+
+template <typename V>
+TraversalScratch<V>& TraversalScratch<V>::local(){
+    static thread_local TraversalScratch<V> scratch;
+    return scratch;
+}
+
+/*
+Level by level, so the depth is known without storing it per vertex and the search stops at maxDepth
+without looking at the next level
+*/
+template <typename G>
+bool bfsVisit(G& g, typename G::vertex_type source, TraversalVisitor<typename G::vertex_type> visitor, int maxDepth,
+              TraversalScratch<typename G::vertex_type>& scratch){
+    using V = typename G::vertex_type;
+    if(source < 1 || source > g.getNumOfVertices()){
+        throw std::invalid_argument("Invalid starting vertex.");
+    }
+    scratch.visited.reset((int)g.getNumOfVertices());
+    scratch.frontier.clear();
+    scratch.next.clear();
+
+    scratch.visited.visit(source - 1);
+    if(!visitor(source, 0)){
+        return false;
+    }
+    scratch.frontier.push_back(source);
+    for(int depth = 1; (maxDepth < 0 || depth <= maxDepth) && !scratch.frontier.isEmpty(); depth++){
+        for(int i = 0; i < scratch.frontier.getSize(); i++){
+            for(const auto& edge : g.neighbors(scratch.frontier[i])){
+                V neighbor = edgeTarget(edge);
+                if(scratch.visited.visit(neighbor - 1)){
+                    if(!visitor(neighbor, depth)){
+                        return false;
+                    }
+                    scratch.next.push_back(neighbor);
+                }
+            }
+        }
+        DynamicArray<V> done = std::move(scratch.frontier);   // swap, both keep their buffers
+        scratch.frontier = std::move(scratch.next);
+        scratch.next = std::move(done);
+        scratch.next.clear();
+    }
+    return true;
+}
+
+template <typename G>
+DynamicArray<Pair<typename G::vertex_type, int>> kHopNeighborhood(G& g, typename G::vertex_type source, int k,
+                                                                  TraversalScratch<typename G::vertex_type>& scratch){
+    using V = typename G::vertex_type;
+    if(k < 0){
+        throw std::invalid_argument("The number of hops can't be negative.");
+    }
+    DynamicArray<Pair<V, int>> result;
+    bfsVisit(g, source, [&result](V vertex, int depth){
+        if(depth > 0){
+            result.push_back(Pair<V, int>(vertex, depth));
+        }
+        return true;
+    }, k, scratch);
+    return result;
+}
+
+template <typename G>
+bool isReachable(G& g, typename G::vertex_type source, typename G::vertex_type target, int maxHops,
+                 TraversalScratch<typename G::vertex_type>& scratch){
+    using V = typename G::vertex_type;
+    if(target < 1 || target > g.getNumOfVertices()){
+        throw std::invalid_argument("Invalid target vertex.");
+    }
+    // the visitor stops exactly when it reaches the target
+    return !bfsVisit(g, source, [target](V vertex, int){
+        return vertex != target;
+    }, maxHops, scratch);
+}
+
+/*
+Explicit instantiations for the supported graph types
+*/
+#define INSTANTIATE_ALGORITHMS(G) \
+    template TreeOf<G> bfs<G>(G& g, typename G::vertex_type startVertex); \
+    template TreeOf<G> dfs<G>(G& g, typename G::vertex_type startVertex); \
+    template TreeOf<G> dijkstra<G>(G& g, typename G::vertex_type startVertex); \
+    template TreeOf<G> prim<G>(G& g); \
+    template TreeOf<G> kruskal<G>(G& g); \
+    template TreeOf<G> parallelKruskal<G>(G& g, ThreadPool& pool); \
+    template TreeOf<G> bfs<G, AlgorithmStats>(G& g, typename G::vertex_type startVertex, AlgorithmStats& counters); \
+    template TreeOf<G> dfs<G, AlgorithmStats>(G& g, typename G::vertex_type startVertex, AlgorithmStats& counters); \
+    template TreeOf<G> dijkstra<G, AlgorithmStats>(G& g, typename G::vertex_type startVertex, AlgorithmStats& counters); \
+    template TreeOf<G> prim<G, AlgorithmStats>(G& g, AlgorithmStats& counters); \
+    template TreeOf<G> kruskal<G, AlgorithmStats>(G& g, AlgorithmStats& counters); \
+    template DynamicArray<TreeOf<G>> bfsBatch<G>(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool); \
+    template DynamicArray<TreeOf<G>> dijkstraBatch<G>(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool); \
+    template DynamicArray<DynamicArray<int>> multiSourceBfs<G, 1>(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool); \
+    template DynamicArray<DynamicArray<int>> multiSourceBfs<G, 4>(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool); \
+    template bool bfsVisit<G>(G& g, typename G::vertex_type source, TraversalVisitor<typename G::vertex_type> visitor, int maxDepth, \
+                              TraversalScratch<typename G::vertex_type>& scratch); \
+    template DynamicArray<Pair<typename G::vertex_type, int>> kHopNeighborhood<G>(G& g, typename G::vertex_type source, int k, \
+                              TraversalScratch<typename G::vertex_type>& scratch); \
+    template bool isReachable<G>(G& g, typename G::vertex_type source, typename G::vertex_type target, int maxHops, \
+                              TraversalScratch<typename G::vertex_type>& scratch);
+
+using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+using GraphF32 = BasicGraph<uint32_t, float>;
+using GraphI64 = BasicGraph<uint32_t, int64_t>;
+using CompressedGraphU8 = BasicCompressedGraph<uint32_t, uint8_t>;
+using CompressedGraphF32 = BasicCompressedGraph<uint32_t, float>;
+using CompressedGraphI64 = BasicCompressedGraph<uint32_t, int64_t>;
+using UnweightedGraphU32 = BasicGraph<uint32_t, uint32_t, Unweighted>;
+
+INSTANTIATE_ALGORITHMS(Graph)
+INSTANTIATE_ALGORITHMS(CompressedGraph)
+INSTANTIATE_ALGORITHMS(GraphU8)
+INSTANTIATE_ALGORITHMS(GraphF32)
+INSTANTIATE_ALGORITHMS(GraphI64)
+INSTANTIATE_ALGORITHMS(CompressedGraphU8)
+INSTANTIATE_ALGORITHMS(CompressedGraphF32)
+INSTANTIATE_ALGORITHMS(CompressedGraphI64)
+INSTANTIATE_ALGORITHMS(UnweightedGraph)
+INSTANTIATE_ALGORITHMS(UnweightedGraphU32)
+INSTANTIATE_ALGORITHMS(GraphSnapshot)
+INSTANTIATE_ALGORITHMS(UnweightedGraphSnapshot)
+INSTANTIATE_ALGORITHMS(SubgraphView)
+INSTANTIATE_ALGORITHMS(EdgeFilterView)
+INSTANTIATE_ALGORITHMS(UnweightedSubgraphView)
+
+#undef INSTANTIATE_ALGORITHMS
+
+template struct TraversalScratch<int>;
+template struct TraversalScratch<uint32_t>;
+
+} // namespace graph
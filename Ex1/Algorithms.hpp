@@ -7,13 +7,135 @@ mail: meyu251@gmail.com
 
 #include <iostream>
 #include "Graph.hpp"
+#include "CompressedGraph.hpp"
+#include "VersionedGraph.hpp"
+#include "GraphView.hpp"
+#include "ThreadPool.hpp"
+#include "Instrumentation.hpp"
 
 namespace graph{
 
-    Graph bfs(Graph& g, int startVertex);
-    Graph dfs(Graph& g, int startVertex);
-    Graph dijkstra(Graph& g, int startVertex);
-    Graph prim(Graph& g);
-    Graph kruskal(Graph& g);
+    /*
+    The algorithms work on every graph representation (G) that offers:
+    vertex_type, weight_type, policy_type, getNumOfVertices(), neighbors(v) and hasNegativeEdge().
+    The neighbors are read with edgeTarget/edgeWeight, so unweighted graphs never touch a stored weight.
+    The result is always a BasicGraph with the same vertex type, weight type and weight policy.
+    The supported graph types are instantiated at the end of Algorithms.cpp
+    */
+    template <typename G>
+    using TreeOf = BasicGraph<typename G::vertex_type, typename G::weight_type, typename G::policy_type>;
 
-}
\ No newline at end of file
+    template <typename G>
+    TreeOf<G> bfs(G& g, typename G::vertex_type startVertex);
+    template <typename G>
+    TreeOf<G> dfs(G& g, typename G::vertex_type startVertex);
+    template <typename G>
+    TreeOf<G> dijkstra(G& g, typename G::vertex_type startVertex);
+    template <typename G>
+    TreeOf<G> prim(G& g);
+    template <typename G>
+    TreeOf<G> kruskal(G& g);
+
+    /*
+    Instrumented runs - the same results, and the counters / phase timings of the run are added to counters.
+    Instantiated with AlgorithmStats (Instrumentation.hpp); the plain versions above use NullCounters.
+    */
+    template <typename G, typename Counters>
+    TreeOf<G> bfs(G& g, typename G::vertex_type startVertex, Counters& counters);
+    template <typename G, typename Counters>
+    TreeOf<G> dfs(G& g, typename G::vertex_type startVertex, Counters& counters);
+    template <typename G, typename Counters>
+    TreeOf<G> dijkstra(G& g, typename G::vertex_type startVertex, Counters& counters);
+    template <typename G, typename Counters>
+    TreeOf<G> prim(G& g, Counters& counters);
+    template <typename G, typename Counters>
+    TreeOf<G> kruskal(G& g, Counters& counters);
+
+    /*
+    Batches - one tree for every source, the sources are processed in parallel on the pool.
+    The graph is only read, the i-th tree is the result of bfs / dijkstra from sources[i].
+    All the sources are checked before any work starts.
+    */
+    template <typename G>
+    DynamicArray<TreeOf<G>> bfsBatch(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool = ThreadPool::shared());
+    template <typename G>
+    DynamicArray<TreeOf<G>> dijkstraBatch(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool = ThreadPool::shared());
+
+    /*
+    Kruskal on the pool - the same tree as kruskal(g). The edges are collected by blocks of vertices and sorted
+    in parallel (sorted runs merged in rounds); the union find pass is sequential.
+    */
+    template <typename G>
+    TreeOf<G> parallelKruskal(G& g, ThreadPool& pool = ThreadPool::shared());
+
+    /*
+    Multi-source BFS - hop distances from many sources without building trees.
+    The sources are processed in groups of 64 * Words: every vertex keeps a bitset with one bit per source of the group,
+    so one scan of an edge moves all the sources that reached its tail at the same level (Words is 1 or 4 - 64 or 256 sources).
+    The groups run in parallel on the pool. levels[i][v - 1] is the number of edges from sources[i] to v, -1 if v is unreachable.
+    */
+    template <typename G, int Words = 1>
+    DynamicArray<DynamicArray<int>> multiSourceBfs(G& g, const DynamicArray<typename G::vertex_type>& sources, ThreadPool& pool = ThreadPool::shared());
+
+    /*
+    Reusable state of the early-exit traversals below: the visited marks are epoch stamped (no O(V) clearing per query)
+    and the frontiers keep their capacity, so a query costs only the vertices it reaches.
+    local() is one scratch per thread and vertex type, used when no scratch is given. A scratch serves one query at a time.
+    */
+    template <typename V>
+    struct TraversalScratch{
+        VisitedSet<uint32_t> visited;
+        DynamicArray<V> frontier;
+        DynamicArray<V> next;
+
+        static TraversalScratch& local();
+    };
+
+    /*
+    A non owning reference to a visitor: bool visitor(V vertex, int depth), returning false stops the traversal.
+    Stored as a function pointer and a pointer to the callable, so the traversals are compiled once for all visitors
+    (the callable must outlive the call, a lambda written in the call is fine).
+    */
+    template <typename V>
+    class TraversalVisitor{
+    private:
+        bool (*call)(void* visitor, V vertex, int depth);
+        void* visitor;
+
+        template <typename F>
+        static bool invoke(void* visitor, V vertex, int depth){
+            return (*static_cast<F*>(visitor))(vertex, depth);
+        }
+
+    public:
+        template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, TraversalVisitor>::value>::type>
+        TraversalVisitor(F&& visitor){
+            using Callable = typename std::remove_reference<F>::type;
+            this->call = &invoke<Callable>;
+            this->visitor = const_cast<void*>(static_cast<const void*>(&visitor));
+        }
+
+        bool operator()(V vertex, int depth) const{
+            return call(visitor, vertex, depth);
+        }
+    };
+
+    /*
+    Early-exit traversals - they stop as soon as the answer is known and never build a tree.
+    maxDepth / maxHops -1 means no limit.
+    */
+    // calls visitor(v, depth) for every vertex reached from source in BFS order (source first, at depth 0),
+    // returns false if the visitor stopped the traversal
+    template <typename G>
+    bool bfsVisit(G& g, typename G::vertex_type source, TraversalVisitor<typename G::vertex_type> visitor, int maxDepth = -1,
+                  TraversalScratch<typename G::vertex_type>& scratch = TraversalScratch<typename G::vertex_type>::local());
+    // the vertices at most k edges from source (source excluded) with their distance, in BFS order
+    template <typename G>
+    DynamicArray<Pair<typename G::vertex_type, int>> kHopNeighborhood(G& g, typename G::vertex_type source, int k,
+                  TraversalScratch<typename G::vertex_type>& scratch = TraversalScratch<typename G::vertex_type>::local());
+    // true if there is a path (of at most maxHops edges) from source to target, stops when target is found
+    template <typename G>
+    bool isReachable(G& g, typename G::vertex_type source, typename G::vertex_type target, int maxHops = -1,
+                  TraversalScratch<typename G::vertex_type>& scratch = TraversalScratch<typename G::vertex_type>::local());
+
+}
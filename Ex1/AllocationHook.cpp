@@ -0,0 +1,117 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+/*
+Replaces the global operator new / delete to count the heap usage of every thread (see AllocationScope).
+Link this file only into programs that want the counters, the others keep the default allocator.
+Every block has a small header in front with its size, so delete knows how much to subtract.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "Instrumentation.hpp"
+
+using namespace graph;
+
+static const std::size_t HEADER = alignof(std::max_align_t);    // keeps the default alignment of the user block
+
+namespace {
+    // installed before main, so AllocationScope::enabled() is true in the whole program
+    struct Installer{
+        Installer(){
+            detail::allocationHookInstalled.store(true, std::memory_order_relaxed);
+        }
+    };
+    Installer installer;
+}
+
+static std::size_t headerSize(std::size_t alignment){
+    return alignment > HEADER ? alignment : HEADER;
+}
+
+static void* allocate(std::size_t size, std::size_t alignment){
+    std::size_t header = headerSize(alignment);
+    void* block;
+    if(alignment > HEADER){
+        std::size_t total = (header + size + alignment - 1) / alignment * alignment;   // aligned_alloc needs a multiple
+        block = std::aligned_alloc(alignment, total);
+    }
+    else{
+        block = std::malloc(header + size);
+    }
+    if(block == nullptr){
+        throw std::bad_alloc();
+    }
+    char* user = static_cast<char*>(block) + header;
+    std::memcpy(user - sizeof(std::size_t), &size, sizeof(std::size_t));
+
+    detail::HeapCounters& counters = detail::heapCounters();
+    counters.current += (long long)size;
+    counters.allocations++;
+    if(counters.current > counters.peak){
+        counters.peak = counters.current;
+    }
+    return user;
+}
+
+static void deallocate(void* pointer, std::size_t alignment) noexcept{
+    if(pointer == nullptr){
+        return;
+    }
+    char* user = static_cast<char*>(pointer);
+    std::size_t size;
+    std::memcpy(&size, user - sizeof(std::size_t), sizeof(std::size_t));
+    detail::heapCounters().current -= (long long)size;
+    std::free(user - headerSize(alignment));
+}
+
+void* operator new(std::size_t size){
+    return allocate(size, 0);
+}
+
+void* operator new[](std::size_t size){
+    return allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment){
+    return allocate(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment){
+    return allocate(size, (std::size_t)alignment);
+}
+
+void operator delete(void* pointer) noexcept{
+    deallocate(pointer, 0);
+}
+
+void operator delete[](void* pointer) noexcept{
+    deallocate(pointer, 0);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept{
+    deallocate(pointer, 0);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept{
+    deallocate(pointer, 0);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept{
+    deallocate(pointer, (std::size_t)alignment);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept{
+    deallocate(pointer, (std::size_t)alignment);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept{
+    deallocate(pointer, (std::size_t)alignment);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t alignment) noexcept{
+    deallocate(pointer, (std::size_t)alignment);
+}
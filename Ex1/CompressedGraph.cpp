@@ -0,0 +1,340 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include "CompressedGraph.hpp"
+
+using namespace graph;
+
+static void writeVarint(unsigned long long value, unsigned char*& out){
+    while(value >= 0x80){
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+}
+
+/*
+Encoding of a single weight (see the decoding in NeighborIterator::decode).
+Signed weights are mapped with zigzag so small negative weights stay short: 0,-1,1,-2,... -> 0,1,2,3,...
+*/
+template <typename W>
+static void writeWeight(W weight, unsigned char*& out){
+    if constexpr(std::is_floating_point<W>::value){
+        std::memcpy(out, &weight, sizeof(W));
+        out += sizeof(W);
+    }
+    else if constexpr(std::is_signed<W>::value){
+        long long value = weight;
+        writeVarint(((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63), out);
+    }
+    else{
+        writeVarint(weight, out);
+    }
+}
+
+template <typename V, typename W>
+static bool byNeighbor(const Pair<V, W>& a, const Pair<V, W>& b){
+    return a.first < b.first;
+}
+
+// the longest varint of a T value (zigzag keeps the bit width)
+template <typename T>
+static int maxVarintSize(){
+    return (int)((sizeof(T) * 8 + 6) / 7);
+}
+
+template <typename W>
+static int maxWeightSize(){
+    if constexpr(std::is_floating_point<W>::value){
+        return sizeof(W);
+    }
+    else{
+        return maxVarintSize<W>();
+    }
+}
+
+// grow buffer (doubling) so that it has room for at least needed bytes
+static void ensureCapacity(unsigned char*& buffer, long long used, long long& capacity, long long needed){
+    if(needed <= capacity){
+        return;
+    }
+    capacity = std::max(needed, capacity * 2);
+    unsigned char* grown = new unsigned char[capacity];
+    if(used > 0){
+        std::memcpy(grown, buffer, used);
+    }
+    delete[] buffer;
+    buffer = grown;
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::BasicCompressedGraph(V n, bool unitWeights){
+    numOfVertices = n;
+    numOfEdges = 0;
+    this->unitWeights = unitWeights;
+    negativeEdge = false;
+    offsets = new long long[n + 1];
+    degrees = new int[n > 0 ? n : 1];
+    bytes = nullptr;
+}
+
+/*
+Build the compressed form of g with the builder, every list is sorted once in a scratch buffer
+that is reused between the vertices
+*/
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::BasicCompressedGraph(const BasicGraph<V, W>& g){
+    // the graph keeps its statistics up to date, no scan is needed for the weights
+    bool unit = g.getNumOfEdges() == 0 || (g.getMinWeight() == W(1) && g.getMaxWeight() == W(1));
+    BasicCompressedGraphBuilder<V, W> builder(g.getNumOfVertices(), unit);
+    SlabArena<Pair<V, W>> scratch;
+    ArenaList<Pair<V, W>> sorted;
+    for(V v = 1; v <= g.getNumOfVertices(); v++){
+        ArrayView<Pair<V, W>> view = g.neighbors(v);
+        if(view.isEmpty()) continue;
+        sorted.assign(view.begin(), view.getSize(), scratch);
+        builder.addList(v, sorted.begin(), sorted.getSize());
+    }
+    BasicCompressedGraph built = builder.finish();
+    moveFrom(built);
+}
+
+template <typename V, typename W>
+void BasicCompressedGraph<V, W>::copyFrom(const BasicCompressedGraph& other){
+    numOfVertices = other.numOfVertices;
+    numOfEdges = other.numOfEdges;
+    unitWeights = other.unitWeights;
+    negativeEdge = other.negativeEdge;
+    long long total = other.getCompressedSize();
+    offsets = new long long[numOfVertices + 1];
+    degrees = new int[numOfVertices > 0 ? numOfVertices : 1];
+    bytes = new unsigned char[total > 0 ? total : 1];
+    offsets[0] = 0;     // other may be a moved from graph without buffers
+    if(other.offsets != nullptr){
+        std::memcpy(offsets, other.offsets, sizeof(long long) * (numOfVertices + 1));
+    }
+    if(numOfVertices > 0){
+        std::memcpy(degrees, other.degrees, sizeof(int) * numOfVertices);
+    }
+    if(total > 0){
+        std::memcpy(bytes, other.bytes, total);
+    }
+}
+
+// copy constructor
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::BasicCompressedGraph(const BasicCompressedGraph& other){
+    copyFrom(other);
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::~BasicCompressedGraph(){
+    delete[] offsets;
+    delete[] degrees;
+    delete[] bytes;
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W>& BasicCompressedGraph<V, W>::operator=(const BasicCompressedGraph& other){
+    if(this != &other){
+        delete[] offsets;
+        delete[] degrees;
+        delete[] bytes;
+        copyFrom(other);
+    }
+    return *this;
+}
+
+// take the buffers of other, other is left as an empty graph without buffers
+template <typename V, typename W>
+void BasicCompressedGraph<V, W>::moveFrom(BasicCompressedGraph& other){
+    numOfVertices = other.numOfVertices;
+    numOfEdges = other.numOfEdges;
+    unitWeights = other.unitWeights;
+    negativeEdge = other.negativeEdge;
+    offsets = other.offsets;
+    degrees = other.degrees;
+    bytes = other.bytes;
+    other.numOfVertices = 0;
+    other.numOfEdges = 0;
+    other.offsets = nullptr;
+    other.degrees = nullptr;
+    other.bytes = nullptr;
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::BasicCompressedGraph(BasicCompressedGraph&& other) noexcept{
+    moveFrom(other);
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W>& BasicCompressedGraph<V, W>::operator=(BasicCompressedGraph&& other) noexcept{
+    if(this != &other){
+        delete[] offsets;
+        delete[] degrees;
+        delete[] bytes;
+        moveFrom(other);
+    }
+    return *this;
+}
+
+template <typename V, typename W>
+V BasicCompressedGraph<V, W>::getNumOfVertices() const{
+    return numOfVertices;
+}
+
+template <typename V, typename W>
+long long BasicCompressedGraph<V, W>::getNumOfEdges() const{
+    return numOfEdges;
+}
+
+template <typename V, typename W>
+int BasicCompressedGraph<V, W>::degree(V vertex) const{
+    if(vertex < 1 || vertex > numOfVertices){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    return degrees[vertex - 1];
+}
+
+/*
+The lists are sorted, so the scan stops as soon as a bigger neighbor is decoded
+*/
+template <typename V, typename W>
+bool BasicCompressedGraph<V, W>::hasEdge(V src, V dest) const{
+    for(const Pair<V, W>& edge : neighbors(src)){
+        if(edge.first == dest) return true;
+        if(edge.first > dest) return false;
+    }
+    return false;
+}
+
+template <typename V, typename W>
+bool BasicCompressedGraph<V, W>::hasNegativeEdge() const{
+    return negativeEdge;
+}
+
+template <typename V, typename W>
+bool BasicCompressedGraph<V, W>::hasUnitWeights() const{
+    return unitWeights;
+}
+
+template <typename V, typename W>
+long long BasicCompressedGraph<V, W>::getCompressedSize() const{
+    return offsets != nullptr ? offsets[numOfVertices] : 0;
+}
+
+template <typename V, typename W>
+MemoryUsage BasicCompressedGraph<V, W>::memoryUsage() const{
+    MemoryUsage usage;
+    if(offsets == nullptr){
+        return usage;
+    }
+    size_t total = (size_t)getCompressedSize();
+    usage.used = sizeof(long long) * ((size_t)numOfVertices + 1) + sizeof(int) * (size_t)numOfVertices + total;
+    usage.reserved = sizeof(long long) * ((size_t)numOfVertices + 1) + sizeof(int) * (numOfVertices > 0 ? (size_t)numOfVertices : 1)
+                   + (total > 0 ? total : 1);
+    return usage;
+}
+
+template <typename V, typename W>
+typename BasicCompressedGraph<V, W>::NeighborRange BasicCompressedGraph<V, W>::neighbors(V vertex) const{
+    if(vertex < 1 || vertex > numOfVertices){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    return NeighborRange(bytes + offsets[vertex - 1], degrees[vertex - 1], unitWeights);
+}
+
+//////////////////////////////////////////
+// BasicCompressedGraphBuilder
+//////////////////////////////////////////
+template <typename V, typename W>
+BasicCompressedGraphBuilder<V, W>::BasicCompressedGraphBuilder(V n, bool unitWeights) : graph(n, unitWeights){
+    nextVertex = 1;
+    maxEdgeSize = maxVarintSize<V>() + (unitWeights ? 0 : maxWeightSize<W>());
+    buffer = nullptr;
+    capacity = 0;
+    total = 0;
+}
+
+template <typename V, typename W>
+BasicCompressedGraphBuilder<V, W>::~BasicCompressedGraphBuilder(){
+    delete[] buffer;
+}
+
+template <typename V, typename W>
+void BasicCompressedGraphBuilder<V, W>::closeUpTo(V vertex){
+    for(; nextVertex < vertex; nextVertex++){
+        graph.offsets[nextVertex - 1] = total;
+        graph.degrees[nextVertex - 1] = 0;
+    }
+}
+
+// the list is encoded into the buffer, which always has room for the worst case of the list
+template <typename V, typename W>
+void BasicCompressedGraphBuilder<V, W>::addList(V vertex, Pair<V, W>* edges, int count){
+    if(graph.offsets == nullptr || vertex < nextVertex || vertex > graph.numOfVertices){
+        throw std::invalid_argument("The lists must be added in increasing vertex order.");
+    }
+    closeUpTo(vertex);
+    std::sort(edges, edges + count, byNeighbor<V, W>);
+    ensureCapacity(buffer, total, capacity, total + count * maxEdgeSize);
+
+    unsigned char* out = buffer + total;
+    V previous = 0;
+    for(int i = 0; i < count; i++){
+        V dest = edges[i].first;
+        W weight = edges[i].second;
+        if(dest < 1 || dest > graph.numOfVertices || dest == vertex || (i > 0 && dest == previous)){
+            throw std::invalid_argument("Invalid edge list.");
+        }
+        if(graph.unitWeights && weight != W(1)){
+            throw std::invalid_argument("A weight other than 1 in a graph with unit weights.");
+        }
+        if(weight < W(0)){
+            graph.negativeEdge = true;
+        }
+        writeVarint((unsigned long long)(dest - previous), out);
+        if(!graph.unitWeights){
+            writeWeight(weight, out);
+        }
+        previous = dest;
+    }
+    graph.offsets[vertex - 1] = total;
+    graph.degrees[vertex - 1] = count;
+    graph.numOfEdges += count;
+    total = out - buffer;
+    nextVertex = vertex + 1;
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W> BasicCompressedGraphBuilder<V, W>::finish(){
+    if(graph.offsets == nullptr){
+        throw std::invalid_argument("The builder is already finished.");
+    }
+    closeUpTo(graph.numOfVertices + 1);
+    graph.offsets[graph.numOfVertices] = total;
+    graph.bytes = new unsigned char[total > 0 ? total : 1];
+    if(total > 0){
+        std::memcpy(graph.bytes, buffer, total);
+    }
+    delete[] buffer;
+    buffer = nullptr;
+    capacity = 0;
+    return std::move(graph);
+}
+
+// The same combinations as BasicGraph
+template class graph::BasicCompressedGraph<int, int>;
+template class graph::BasicCompressedGraph<uint32_t, uint8_t>;
+template class graph::BasicCompressedGraph<uint32_t, float>;
+template class graph::BasicCompressedGraph<uint32_t, int64_t>;
+template class graph::BasicCompressedGraphBuilder<int, int>;
+template class graph::BasicCompressedGraphBuilder<uint32_t, uint8_t>;
+template class graph::BasicCompressedGraphBuilder<uint32_t, float>;
+template class graph::BasicCompressedGraphBuilder<uint32_t, int64_t>;
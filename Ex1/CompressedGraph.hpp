@@ -0,0 +1,238 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <cstring>
+#include "Graph.hpp"
+#include "Data_Structures.hpp"
+
+namespace graph {
+
+    template <typename V, typename W>
+    class BasicCompressedGraphBuilder;
+
+    /*
+    Read-only, compressed adjacency representation of a Graph.
+    The neighbors of every vertex are sorted and stored as gaps encoded with varints
+    (7 bits per byte, the high bit marks that more bytes follow).
+    Weights are stored right after each neighbor (zigzag varint for signed integers,
+    plain varint for unsigned integers and the raw bytes for floating point weights),
+    and are omitted completely when all the weights in the graph are 1.
+    */
+    template <typename V, typename W>
+    class BasicCompressedGraph{
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using policy_type = Weighted;   // the iterator always yields (neighbor, weight)
+        using edge_type = Pair<V, W>;
+
+    private:
+        V numOfVertices;
+        long long numOfEdges;
+        bool unitWeights;           // true if all the weights are 1 (weights are not stored)
+        bool negativeEdge;          // true if there is an edge with a negative weight
+        long long* offsets;         // offsets[i] = start of the encoded list of vertex (i+1), offsets[n] = total bytes
+        int* degrees;               // out degree of every vertex
+        unsigned char* bytes;       // the encoded adjacency lists
+
+        void copyFrom(const BasicCompressedGraph& other);
+        void moveFrom(BasicCompressedGraph& other);
+        BasicCompressedGraph(V n, bool unitWeights);    // no edges and no bytes yet, filled by the builder
+
+        friend class BasicCompressedGraphBuilder<V, W>;
+
+    public:
+
+        // Decodes the neighbors of a single vertex one by one
+        class NeighborIterator{
+        private:
+            const unsigned char* pos;
+            int remaining;
+            bool unitWeights;
+            Pair<V, W> current;   // (neighbor, weight)
+
+            void decode();
+
+        public:
+            NeighborIterator(const unsigned char* pos, int count, bool unitWeights);
+            const Pair<V, W>& operator*() const;
+            const Pair<V, W>* operator->() const;
+            NeighborIterator& operator++();
+            bool operator!=(const NeighborIterator& other) const;
+            bool operator==(const NeighborIterator& other) const;
+        };  // class NeighborIterator
+
+        class NeighborRange{
+        private:
+            const unsigned char* start;
+            int count;
+            bool unitWeights;
+
+        public:
+            NeighborRange(const unsigned char* start, int count, bool unitWeights);
+            NeighborIterator begin() const;
+            NeighborIterator end() const;
+            int getSize() const;
+        };  // class NeighborRange
+
+        BasicCompressedGraph(const BasicGraph<V, W>& g);
+        BasicCompressedGraph(const BasicCompressedGraph& other);
+        BasicCompressedGraph(BasicCompressedGraph&& other) noexcept;
+        ~BasicCompressedGraph();
+        BasicCompressedGraph& operator=(const BasicCompressedGraph& other);
+        BasicCompressedGraph& operator=(BasicCompressedGraph&& other) noexcept;
+
+        V getNumOfVertices() const;
+        long long getNumOfEdges() const;
+        int degree(V vertex) const;
+        bool hasEdge(V src, V dest) const;
+        bool hasNegativeEdge() const;
+        bool hasUnitWeights() const;
+        long long getCompressedSize() const;    // bytes used by the encoded lists
+        MemoryUsage memoryUsage() const;        // offsets, degrees and the encoded lists (allocated to the exact size)
+        NeighborRange neighbors(V vertex) const;
+
+    };  // class BasicCompressedGraph
+
+    /*
+    Builds a BasicCompressedGraph list by list, without a BasicGraph in memory (e.g. from a binary edge file,
+    see readCompressed in ExternalMemory.hpp). The lists are added in increasing vertex order (a skipped vertex
+    has no edges), and every list is sorted and encoded as soon as it is added, so only the encoded bytes and
+    the list being added are kept. Whether all the weights are 1 (then they are not stored) must be known up front.
+    */
+    template <typename V, typename W>
+    class BasicCompressedGraphBuilder{
+    private:
+        BasicCompressedGraph<V, W> graph;
+        V nextVertex;               // the lists of the vertices before it are done
+        long long maxEdgeSize;      // the longest encoding of one edge
+        unsigned char* buffer;      // the encoded lists, grown by doubling
+        long long capacity;
+        long long total;
+
+        void closeUpTo(V vertex);   // empty lists for the vertices from nextVertex to vertex - 1
+
+    public:
+        BasicCompressedGraphBuilder(V n, bool unitWeights);
+        ~BasicCompressedGraphBuilder();
+        BasicCompressedGraphBuilder(const BasicCompressedGraphBuilder& other) = delete;
+        BasicCompressedGraphBuilder& operator=(const BasicCompressedGraphBuilder& other) = delete;
+
+        // the out edges of vertex, sorted in place. Throws if vertex is not after the last list, or on an invalid
+        // or repeated neighbor, a self loop or (with unit weights) a weight other than 1
+        void addList(V vertex, Pair<V, W>* edges, int count);
+        BasicCompressedGraph<V, W> finish();    // the encoded bytes are copied to the exact size, the builder is done
+
+    };  // class BasicCompressedGraphBuilder
+
+    using CompressedGraph = BasicCompressedGraph<int, int>;
+    using CompressedGraphBuilder = BasicCompressedGraphBuilder<int, int>;
+
+
+//////////////////////////////////////////
+// NeighborIterator
+//////////////////////////////////////////
+// The iterator is defined here so the decoding loop can be inlined into the algorithms
+
+inline unsigned long long readVarint(const unsigned char*& pos){
+    unsigned long long value = 0;
+    int shift = 0;
+    while(*pos & 0x80){
+        value |= (unsigned long long)(*pos++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= (unsigned long long)(*pos++) << shift;
+    return value;
+}
+
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::NeighborIterator::NeighborIterator(const unsigned char* pos, int count, bool unitWeights){
+    this->pos = pos;
+    this->remaining = count;
+    this->unitWeights = unitWeights;
+    current.first = 0;      // the first gap is relative to 0
+    current.second = W(1);
+    if(remaining > 0){
+        decode();
+    }
+}
+
+template <typename V, typename W>
+void BasicCompressedGraph<V, W>::NeighborIterator::decode(){
+    current.first += (V)readVarint(pos);
+
+    if(!unitWeights){
+        if constexpr(std::is_floating_point<W>::value){
+            std::memcpy(&current.second, pos, sizeof(W));
+            pos += sizeof(W);
+        }
+        else if constexpr(std::is_signed<W>::value){
+            unsigned long long zigzag = readVarint(pos);
+            current.second = (W)((long long)(zigzag >> 1) ^ -(long long)(zigzag & 1));
+        }
+        else{
+            current.second = (W)readVarint(pos);
+        }
+    }
+}
+
+template <typename V, typename W>
+const Pair<V, W>& BasicCompressedGraph<V, W>::NeighborIterator::operator*() const{
+    return current;
+}
+
+template <typename V, typename W>
+const Pair<V, W>* BasicCompressedGraph<V, W>::NeighborIterator::operator->() const{
+    return &current;
+}
+
+template <typename V, typename W>
+typename BasicCompressedGraph<V, W>::NeighborIterator& BasicCompressedGraph<V, W>::NeighborIterator::operator++(){
+    remaining--;
+    if(remaining > 0){
+        decode();
+    }
+    return *this;
+}
+
+// iterators of the same list are equal when the same number of neighbors is left
+template <typename V, typename W>
+bool BasicCompressedGraph<V, W>::NeighborIterator::operator!=(const NeighborIterator& other) const{
+    return remaining != other.remaining;
+}
+
+template <typename V, typename W>
+bool BasicCompressedGraph<V, W>::NeighborIterator::operator==(const NeighborIterator& other) const{
+    return remaining == other.remaining;
+}
+
+//////////////////////////////////////////
+// NeighborRange
+//////////////////////////////////////////
+template <typename V, typename W>
+BasicCompressedGraph<V, W>::NeighborRange::NeighborRange(const unsigned char* start, int count, bool unitWeights){
+    this->start = start;
+    this->count = count;
+    this->unitWeights = unitWeights;
+}
+
+template <typename V, typename W>
+typename BasicCompressedGraph<V, W>::NeighborIterator BasicCompressedGraph<V, W>::NeighborRange::begin() const{
+    return NeighborIterator(start, count, unitWeights);
+}
+
+template <typename V, typename W>
+typename BasicCompressedGraph<V, W>::NeighborIterator BasicCompressedGraph<V, W>::NeighborRange::end() const{
+    return NeighborIterator(start, 0, unitWeights);
+}
+
+template <typename V, typename W>
+int BasicCompressedGraph<V, W>::NeighborRange::getSize() const{
+    return count;
+}
+
+}  // namespace graph
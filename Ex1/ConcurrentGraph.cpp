@@ -0,0 +1,216 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <stdexcept>
+#include "ConcurrentGraph.hpp"
+
+using namespace graph;
+
+template <typename V, typename W, typename P>
+BasicConcurrentGraph<V, W, P>::BasicConcurrentGraph(V n, int numShards) : numOfEdges(0), negativeEdges(0){
+    if(numShards < 1){
+        throw std::invalid_argument("A concurrent graph needs at least one shard.");
+    }
+    this->lists = new DynamicArray<edge_type>[n > 0 ? n : 1];
+    this->shards = new Shard[numShards];
+    this->numShards = numShards;
+    this->numOfVertices = n;
+}
+
+template <typename V, typename W, typename P>
+BasicConcurrentGraph<V, W, P>::~BasicConcurrentGraph(){
+    delete[] lists;
+    delete[] shards;
+}
+
+template <typename V, typename W, typename P>
+std::mutex& BasicConcurrentGraph<V, W, P>::shardOf(V vertex) const{
+    return shards[((long)vertex - 1) % numShards].lock;
+}
+
+template <typename V, typename W, typename P>
+bool BasicConcurrentGraph<V, W, P>::validVertex(V vertex) const{
+    return vertex >= 1 && vertex <= numOfVertices;
+}
+
+template <typename V, typename W, typename P>
+bool BasicConcurrentGraph<V, W, P>::findEdge(V src, V dest) const{
+    for(const edge_type& edge : lists[src - 1]){
+        if(edgeTarget(edge) == dest){
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename V, typename W, typename P>
+void BasicConcurrentGraph<V, W, P>::appendEdge(V src, V dest, W weight){
+    if constexpr(std::is_same<P, Unweighted>::value){
+        lists[src - 1].push_back(dest);
+    }
+    else{
+        lists[src - 1].push_back(edge_type(dest, weight));
+    }
+    numOfEdges.fetch_add(1, std::memory_order_relaxed);
+    if(weight < W(0)) negativeEdges.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename V, typename W, typename P>
+EdgeStatus BasicConcurrentGraph<V, W, P>::addBothLocked(V src, V dest, W weight){
+    bool srcEdge = findEdge(src, dest);
+    bool destEdge = findEdge(dest, src);
+    if(srcEdge && destEdge){
+        return EdgeStatus::AlreadyExists;
+    }
+    if(std::is_same<P, Unweighted>::value && weight != W(1)){
+        return EdgeStatus::InvalidWeight;
+    }
+    if(!srcEdge){
+        appendEdge(src, dest, weight);
+    }
+    if(!destEdge){
+        appendEdge(dest, src, weight);
+    }
+    return srcEdge ? EdgeStatus::ForwardExisted : destEdge ? EdgeStatus::BackwardExisted : EdgeStatus::Added;
+}
+
+template <typename V, typename W, typename P>
+V BasicConcurrentGraph<V, W, P>::getNumOfVertices() const{
+    return numOfVertices;
+}
+
+template <typename V, typename W, typename P>
+long long BasicConcurrentGraph<V, W, P>::getNumOfEdges() const{
+    return numOfEdges.load(std::memory_order_relaxed);
+}
+
+template <typename V, typename W, typename P>
+int BasicConcurrentGraph<V, W, P>::getNumOfShards() const{
+    return numShards;
+}
+
+template <typename V, typename W, typename P>
+EdgeStatus BasicConcurrentGraph<V, W, P>::tryAddEdge(V src, V dest, W weight){
+    if(!validVertex(src) || !validVertex(dest) || src == dest){
+        return EdgeStatus::Invalid;
+    }
+    std::mutex& srcShard = shardOf(src);
+    std::mutex& destShard = shardOf(dest);
+    if(&srcShard == &destShard){
+        std::lock_guard<std::mutex> guard(srcShard);
+        return addBothLocked(src, dest, weight);
+    }
+    std::scoped_lock guard(srcShard, destShard);   // deadlock free for any order of the two
+    return addBothLocked(src, dest, weight);
+}
+
+template <typename V, typename W, typename P>
+EdgeStatus BasicConcurrentGraph<V, W, P>::tryAddDirectedEdge(V src, V dest, W weight){
+    if(!validVertex(src) || !validVertex(dest) || src == dest){
+        return EdgeStatus::Invalid;
+    }
+    std::lock_guard<std::mutex> guard(shardOf(src));
+    if(findEdge(src, dest)){
+        return EdgeStatus::AlreadyExists;
+    }
+    if(std::is_same<P, Unweighted>::value && weight != W(1)){
+        return EdgeStatus::InvalidWeight;
+    }
+    appendEdge(src, dest, weight);
+    return EdgeStatus::Added;
+}
+
+template <typename V, typename W, typename P>
+void BasicConcurrentGraph<V, W, P>::removeEdge(V src, V dest){
+    if(!validVertex(src)){
+        throw std::invalid_argument("Edge does not exist.");
+    }
+    std::lock_guard<std::mutex> guard(shardOf(src));
+    DynamicArray<edge_type>& list = lists[src - 1];
+    for(int i = 0; i < list.getSize(); i++){
+        if(edgeTarget(list[i]) == dest){
+            if(edgeWeight<W>(list[i]) < W(0)) negativeEdges.fetch_sub(1, std::memory_order_relaxed);
+            list.removeAtUnordered(i);
+            numOfEdges.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    throw std::invalid_argument("Edge does not exist.");
+}
+
+template <typename V, typename W, typename P>
+bool BasicConcurrentGraph<V, W, P>::hasEdge(V src, V dest) const{
+    if(!validVertex(src)){
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(shardOf(src));
+    return findEdge(src, dest);
+}
+
+template <typename V, typename W, typename P>
+int BasicConcurrentGraph<V, W, P>::degree(V vertex) const{
+    if(!validVertex(vertex)){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    std::lock_guard<std::mutex> guard(shardOf(vertex));
+    return lists[vertex - 1].getSize();
+}
+
+template <typename V, typename W, typename P>
+bool BasicConcurrentGraph<V, W, P>::hasNegativeEdge() const{
+    return negativeEdges.load(std::memory_order_relaxed) > 0;
+}
+
+template <typename V, typename W, typename P>
+LoadReport BasicConcurrentGraph<V, W, P>::loadEdges(const DynamicArray<Pair<Pair<V, V>, W>>& edges, bool directed, ThreadPool& pool){
+    LoadReport report;
+    std::mutex reportLock;
+    pool.parallel_for_range(0, edges.getSize(), [&](long begin, long end){
+        LoadReport local;
+        for(long i = begin; i < end; i++){
+            const Pair<Pair<V, V>, W>& edge = edges[i];
+            if(directed){
+                local.count(tryAddDirectedEdge(edge.first.first, edge.first.second, edge.second));
+            }
+            else{
+                local.count(tryAddEdge(edge.first.first, edge.first.second, edge.second));
+            }
+        }
+        std::lock_guard<std::mutex> guard(reportLock);
+        report.added += local.added;
+        report.completed += local.completed;
+        report.duplicates += local.duplicates;
+        report.invalid += local.invalid;
+    });
+    return report;
+}
+
+/*
+One shard at a time, so the writers of the other shards keep going while it is copied.
+Every list is copied straight into the list of the graph (the lists never hold duplicates),
+so there is no intermediate array of all the edges.
+*/
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P> BasicConcurrentGraph<V, W, P>::freeze() const{
+    BasicGraph<V, W, P> g(numOfVertices);
+    for(int shard = 0; shard < numShards; shard++){
+        std::lock_guard<std::mutex> guard(shards[shard].lock);
+        for(long v = shard + 1; v <= (long)numOfVertices; v += numShards){
+            const DynamicArray<edge_type>& list = lists[v - 1];
+            if(!list.isEmpty()){
+                g.appendUniqueEdges((V)v, ArrayView<edge_type>(list.begin(), list.getSize()));
+            }
+        }
+    }
+    return g;
+}
+
+// The same (vertex id, weight) combinations as BasicGraph
+template class graph::BasicConcurrentGraph<int, int>;
+template class graph::BasicConcurrentGraph<uint32_t, uint8_t>;
+template class graph::BasicConcurrentGraph<uint32_t, float>;
+template class graph::BasicConcurrentGraph<uint32_t, int64_t>;
+template class graph::BasicConcurrentGraph<int, int, graph::Unweighted>;
+template class graph::BasicConcurrentGraph<uint32_t, uint32_t, graph::Unweighted>;
@@ -0,0 +1,84 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+namespace graph {
+
+    /*
+    A mutable graph for parallel ingestion - any number of threads add and remove edges at the same time.
+    Every vertex belongs to one of numShards locks (by its id modulo numShards), an operation locks only the shards
+    of its vertices (an undirected edge locks both, always in the same order), so threads that touch different
+    vertices don't wait for each other. The counters are atomic.
+    When the ingestion is done, freeze() returns an ordinary BasicGraph (and a CompressedGraph can be built from it)
+    for the algorithms.
+    */
+    template <typename V, typename W, typename P = Weighted>
+    class BasicConcurrentGraph{
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using policy_type = P;
+        using edge_type = typename P::template Entry<V, W>;
+
+    private:
+        struct alignas(64) Shard{      // one cache line per lock, so neighbor locks don't share a line
+            std::mutex lock;
+        };
+
+        DynamicArray<edge_type>* lists;     // lists[i] - the neighbors of vertex (i+1), guarded by its shard
+        Shard* shards;
+        int numShards;
+        V numOfVertices;
+        std::atomic<long long> numOfEdges;
+        std::atomic<long long> negativeEdges;
+
+        std::mutex& shardOf(V vertex) const;
+        bool validVertex(V vertex) const;
+        bool findEdge(V src, V dest) const;         // the shard of src must be locked
+        void appendEdge(V src, V dest, W weight);   // the shard of src must be locked
+        EdgeStatus addBothLocked(V src, V dest, W weight);  // both shards must be locked
+
+    public:
+        BasicConcurrentGraph(V n, int numShards = 256);
+        ~BasicConcurrentGraph();
+
+        BasicConcurrentGraph(const BasicConcurrentGraph& other) = delete;
+        BasicConcurrentGraph& operator=(const BasicConcurrentGraph& other) = delete;
+
+        V getNumOfVertices() const;
+        long long getNumOfEdges() const;    // directed entries (an undirected edge counts twice)
+        int getNumOfShards() const;
+
+        // thread safe, the same rules and results as the silent insertion of BasicGraph
+        EdgeStatus tryAddEdge(V src, V dest, W weight = W(1));
+        EdgeStatus tryAddDirectedEdge(V src, V dest, W weight = W(1));
+        void removeEdge(V src, V dest);     // removes the directed edge, throws if it doesn't exist
+        bool hasEdge(V src, V dest) const;
+        int degree(V vertex) const;
+        bool hasNegativeEdge() const;
+
+        // inserts the edges in parallel on the pool, every edge is counted in the report by its status
+        LoadReport loadEdges(const DynamicArray<Pair<Pair<V, V>, W>>& edges, bool directed = false,
+                             ThreadPool& pool = ThreadPool::shared());
+
+        /*
+        A read-only copy for the algorithms, exact once the writers are done.
+        It copies one shard at a time under its lock, so it is safe while writers still run,
+        but then it holds each shard as it was when that shard was copied.
+        */
+        BasicGraph<V, W, P> freeze() const;
+
+    };  // class BasicConcurrentGraph
+
+    using ConcurrentGraph = BasicConcurrentGraph<int, int>;
+    using UnweightedConcurrentGraph = BasicConcurrentGraph<int, int, Unweighted>;
+
+}  // namespace graph
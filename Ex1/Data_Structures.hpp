@@ -7,12 +7,39 @@ mail: meyu251@gmail.com
 
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace graph {
+
+    /*
+    The heap memory of a structure: used - bytes that hold elements, reserved - bytes allocated.
+    Only the structure's own buffers are counted, not memory owned by the elements.
+    */
+    struct MemoryUsage{
+        std::size_t used = 0;
+        std::size_t reserved = 0;
+
+        std::size_t slack() const{ return reserved - used; }
+        MemoryUsage& operator+=(const MemoryUsage& other){
+            used += other.used;
+            reserved += other.reserved;
+            return *this;
+        }
+    };
     
     //////////////////////////////////////////
     // DynamicArray
     //////////////////////////////////////////
+    // The storage is allocated uninitialized, elements are constructed only when they are added
     template <typename T>
     class DynamicArray {
     private:
@@ -21,22 +48,42 @@ namespace graph {
         int size;   // current size of the array
 
         void resize(int newCapacity);
+        static T* allocate(int capacity);
+        static void moveElements(T* from, int count, T* to);   // move construct into to, destroy in from
+        void destroyAll();
 
     public:
 
         DynamicArray();
         DynamicArray(int capacity);
         DynamicArray(const DynamicArray& other);
+        DynamicArray(DynamicArray&& other) noexcept;
         ~DynamicArray();
         DynamicArray& operator=(const DynamicArray& other);
+        DynamicArray& operator=(DynamicArray&& other) noexcept;
 
         void push_back(const T& value); // add an element to the end of the array
+        void push_back(T&& value);
+        template <typename... Args>
+        T& emplace_back(Args&&... args);    // construct an element in place at the end of the array
         void removeAt(int index);
+        void removeAtUnordered(int index);  // O(1) - the last element takes the place of the removed one
+        void reserve(int newCapacity);      // make room for newCapacity elements without changing the size
+        void shrink_to_fit();               // release the unused capacity
+        void clear();
         T& get(int index);
         int getSize() const;
+        int getCapacity() const;
+        MemoryUsage memoryUsage() const;
         bool isEmpty() const;
         T& operator[](int index);
         const T& operator[](int index) const;
+
+        // Iteration over the stored elements (no bounds checks)
+        T* begin();
+        T* end();
+        const T* begin() const;
+        const T* end() const;
     };  // class DynamicArray
 
 
@@ -54,23 +101,90 @@ namespace graph {
         bool operator<(const Pair<T1, T2>& other) const;
     };  // class Pair
 
+    //////////////////////////////////////////
+    // Comparators
+    //////////////////////////////////////////
+    // Pair::operator< compares only second, these make the other orders explicit
+    struct LessBySecond {
+        template <typename T1, typename T2>
+        bool operator()(const Pair<T1, T2>& a, const Pair<T1, T2>& b) const;
+    };
+
+    struct LessByFirst {
+        template <typename T1, typename T2>
+        bool operator()(const Pair<T1, T2>& a, const Pair<T1, T2>& b) const;
+    };
+
+    // by second, ties are broken by first
+    struct LessBySecondThenFirst {
+        template <typename T1, typename T2>
+        bool operator()(const Pair<T1, T2>& a, const Pair<T1, T2>& b) const;
+    };
+
+    // the opposite order of Compare (turns a min-heap into a max-heap)
+    template <typename Compare>
+    struct Reverse {
+        Compare compare;
+        Reverse(const Compare& compare = Compare());
+        template <typename T>
+        bool operator()(const T& a, const T& b) const;
+    };
+
+    // compares the keys that KeyFn extracts from the elements
+    template <typename KeyFn, typename Compare = std::less<>>
+    struct KeyCompare {
+        KeyFn key;
+        Compare compare;
+        KeyCompare(const KeyFn& key = KeyFn(), const Compare& compare = Compare());
+        template <typename T>
+        bool operator()(const T& a, const T& b) const;
+    };
+
+    // Stores the comparator of a container; an empty (stateless) comparator takes no space
+    template <typename Compare, bool Empty = std::is_empty<Compare>::value && !std::is_final<Compare>::value>
+    class CompareHolder : private Compare {
+    protected:
+        CompareHolder(const Compare& compare) : Compare(compare) {}
+        const Compare& comparator() const { return *this; }
+    };
+
+    template <typename Compare>
+    class CompareHolder<Compare, false> {
+    private:
+        Compare compare;
+    protected:
+        CompareHolder(const Compare& compare) : compare(compare) {}
+        const Compare& comparator() const { return compare; }
+    };
+
     //////////////////////////////////////////
     // Queue
     //////////////////////////////////////////
+    // Ring buffer with a power of two capacity, so the positions wrap with a mask instead of %
     template <typename T>
     class Queue {
     private:
-        DynamicArray<T> data;
+        T* data;        // uninitialized storage, only the elements in the queue are constructed
+        int capacity;   // 0 or a power of two
         int head;
-        int tail;
         int size;
-        
+
+        void grow(int minCapacity);     // move the elements once into a bigger buffer
+        void release();                 // destroy the elements and free the buffer
+
     public:
         Queue();
+        Queue(const Queue& other);
+        Queue(Queue&& other) noexcept;
         ~Queue();
+        Queue& operator=(const Queue& other);
+        Queue& operator=(Queue&& other) noexcept;
 
         void enqueue(const T& value);
+        void enqueue(T&& value);
+        void enqueueRange(const DynamicArray<T>& values);   // enqueue all the values in order
         T dequeue();
+        void drain(DynamicArray<T>& out);   // move all the elements (in order) to the end of out
         T peek();
         int getSize() const;
         bool isEmpty() const;
@@ -102,24 +216,49 @@ namespace graph {
     //////////////////////////////////////////
     // PriorityQueue
     //////////////////////////////////////////
-    template <typename T>
-    class PriorityQueue {
+    /*
+    Heap with Arity children per node (4 by default), the top is the smallest element by Compare
+    (a min-heap by operator< by default, Reverse<...> gives a max-heap).
+    The buffer is aligned to a cache line and the root is placed at slot Arity-1,
+    so the children of every node (one sibling group) start at a multiple of Arity
+    and a sibling group never crosses a cache line (when Arity * sizeof(T) divides 64).
+    */
+    template <typename T, typename Compare = std::less<T>, int Arity = 4>
+    class PriorityQueue : private CompareHolder<Compare> {
     private:
-        DynamicArray<T> heap;
+        static_assert(Arity >= 2, "PriorityQueue needs at least 2 children per node");
+        static const int OFFSET = Arity - 1;    // padding slots before the root
+        static const size_t ALIGNMENT = 64;     // cache line
+
+        T* buffer;      // aligned, uninitialized storage
+        T* heap;        // buffer + OFFSET, heap[0] is the root
+        int capacity;
         int size;
 
         void heapifyUp(int index);
         void heapifyDown(int index);
+        void buildHeap();               // Floyd's O(n) construction over the whole array
+        void grow(int minCapacity);
+        void release();
 
     public:
         PriorityQueue();
+        explicit PriorityQueue(const Compare& compare);
+        PriorityQueue(const DynamicArray<T>& values, const Compare& compare = Compare());   // O(n) bulk construction
+        PriorityQueue(const PriorityQueue& other);
+        PriorityQueue(PriorityQueue&& other) noexcept;
         ~PriorityQueue();
+        PriorityQueue& operator=(const PriorityQueue& other);
+        PriorityQueue& operator=(PriorityQueue&& other) noexcept;
 
         void enqueue(const T& value);
+        void pushRange(const DynamicArray<T>& values);  // enqueue all the values
         T dequeue();
         const T& peek() const;
+        void reserve(int newCapacity);
         int getSize() const;
         bool isEmpty() const;
+        MemoryUsage memoryUsage() const;    // the padding slots before the root are reserved
         void printHeap() const;     // For debug
     };
 
@@ -139,18 +278,212 @@ namespace graph {
         T find(T x);                // Find the set that the element belongs to
         void unionSets(T x, T y);
         bool isSameSet(T x, T y);   // Check if two elements are in the same set
+        MemoryUsage memoryUsage() const;
     };  // class DisjointSet
 
+    //////////////////////////////////////////
+    // VisitedSet
+    //////////////////////////////////////////
+    /*
+    Visited marks that are cleared in O(1): every pass has its own epoch and an element is visited
+    when its stamp equals the current epoch. The stamps are cleared only when the epoch wraps around,
+    so a small Stamp type saves memory at the cost of a clear every 2^bits - 1 passes.
+    */
+    template <typename Stamp = uint32_t>
+    class VisitedSet {
+    private:
+        static_assert(std::is_unsigned<Stamp>::value, "VisitedSet stamps must be unsigned");
+        DynamicArray<Stamp> stamps;
+        Stamp epoch;
+
+    public:
+        VisitedSet();
+
+        void reset(int n);              // start a new pass over the elements 0 .. n-1 (grows if needed)
+        bool visit(int index);          // mark the element, false if it was already visited in this pass
+        bool isVisited(int index) const;
+        int getSize() const;
+        MemoryUsage memoryUsage() const;
+    };  // class VisitedSet
+
+    //////////////////////////////////////////
+    // ArrayView
+    //////////////////////////////////////////
+    // Read-only view over a contiguous range of elements owned by someone else
+    template <typename T>
+    class ArrayView {
+    private:
+        const T* data;
+        int size;
+
+    public:
+        ArrayView(const T* data, int size);
+
+        int getSize() const;
+        bool isEmpty() const;
+        const T& operator[](int index) const;
+        const T* begin() const;
+        const T* end() const;
+    };  // class ArrayView
+
+    //////////////////////////////////////////
+    // SlabArena
+    //////////////////////////////////////////
+    // Hands out blocks of T from a few large slabs with bump allocation.
+    // Block sizes are powers of two; released blocks are kept in a free list per size and reused.
+    // All the slabs are freed at once by clear() or the destructor.
+    // The elements are never constructed or destroyed, so T must be trivially copyable.
+    template <typename T>
+    class SlabArena {
+    private:
+        struct alignas(std::max_align_t) Slab {
+            Slab* next;
+            size_t capacity;    // in elements
+            size_t used;
+        };
+
+        static const int NUM_CLASSES = 32;
+        static const size_t MIN_SLAB = 1024;        // elements in the first slab
+        static const size_t MAX_SLAB = 1 << 20;     // slabs stop growing at this size
+
+        Slab* slabs;
+        T* freeLists[NUM_CLASSES];  // freeLists[k] = released blocks of 2^k elements
+        size_t nextSlabSize;
+        size_t reservedBytes;
+
+        static int sizeClass(int count);
+        void addSlab(size_t minElements);
+
+    public:
+        SlabArena();
+        ~SlabArena();
+        SlabArena(const SlabArena& other) = delete;
+        SlabArena& operator=(const SlabArena& other) = delete;
+        SlabArena(SlabArena&& other) noexcept;
+        SlabArena& operator=(SlabArena&& other) noexcept;
+
+        static int blockSize(int count);    // the block size that will be used for count elements
+        void reserve(size_t elements);      // make sure the next slab can hold at least this many elements
+        T* allocate(int count);             // count is rounded up to blockSize(count)
+        void release(T* block, int count);  // count must be the one used to allocate the block
+        void clear();
+        size_t getReservedBytes() const;
+    };  // class SlabArena
+
+    //////////////////////////////////////////
+    // ArenaList
+    //////////////////////////////////////////
+    // A growable list whose storage comes from a SlabArena that is passed to every growing call.
+    // Used for the adjacency lists of a graph, so all the lists share the same slabs.
+    template <typename T>
+    class ArenaList {
+    private:
+        T* data;
+        int size;
+        int capacity;
+
+    public:
+        ArenaList();
+
+        void push_back(const T& value, SlabArena<T>& arena);
+        void assign(const T* values, int count, SlabArena<T>& arena);   // replace the content with a copy of values
+        void reserve(int newCapacity, SlabArena<T>& arena);     // room for newCapacity elements without growing
+        void removeAt(int index);
+        void removeAtUnordered(int index);  // O(1) - the last element takes the place of the removed one
+        void truncate(int newSize);         // keep only the first newSize elements
+        T& get(int index);
+        const T& get(int index) const;
+        int getSize() const;
+        bool isEmpty() const;
+        ArrayView<T> view() const;
+        T* begin();
+        T* end();
+        const T* begin() const;
+        const T* end() const;
+    };  // class ArenaList
+
+    //////////////////////////////////////////
+    // MPMCQueue
+    //////////////////////////////////////////
+    /*
+    Bounded lock-free queue for many producers and many consumers (D. Vyukov's array queue).
+    Every slot has a sequence number that tells whose turn it is:
+    sequence == position           - the slot is free for the producer of that position
+    sequence == position + 1       - the slot holds the value for the consumer of that position
+    A thread claims a position with a single compare-and-swap on the head or on the tail,
+    so the threads don't block each other and no locks are taken.
+    The capacity is rounded up to a power of two and never changes.
+    */
+    template <typename T>
+    class MPMCQueue {
+    private:
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        struct alignas(CACHE_LINE) Slot {
+            std::atomic<std::size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];    // constructed only while the slot is full
+
+            T* value();
+        };
+
+        Slot* slots;
+        std::size_t mask;       // capacity - 1
+        // the positions are on separate cache lines so producers and consumers don't share a line
+        alignas(CACHE_LINE) std::atomic<std::size_t> enqueuePos;
+        alignas(CACHE_LINE) std::atomic<std::size_t> dequeuePos;
+
+        template <typename U>
+        bool push(U&& value);
+
+    public:
+        MPMCQueue(std::size_t capacity);
+        MPMCQueue(const MPMCQueue& other) = delete;     // shared between threads, never copied
+        MPMCQueue& operator=(const MPMCQueue& other) = delete;
+        ~MPMCQueue();
+
+        bool tryEnqueue(const T& value);    // false if the queue is full
+        bool tryEnqueue(T&& value);
+        bool tryDequeue(T& out);            // false if the queue is empty
+        void enqueue(const T& value);       // spin until there is room
+        T dequeue();                        // spin until there is a value
+        std::size_t getCapacity() const;
+        std::size_t approxSize() const;     // exact only when no other thread uses the queue
+        bool isEmpty() const;               // the same as approxSize() == 0
+
+    };  // class MPMCQueue
+
 
 
 //////////////////////////////////////////
 // DynamicArray
 //////////////////////////////////////////    
 template <typename T>
+T* DynamicArray<T>::allocate(int capacity){
+    return static_cast<T*>(::operator new(sizeof(T) * capacity));
+}
+
+template <typename T>
+void DynamicArray<T>::moveElements(T* from, int count, T* to){
+    for(int i = 0; i < count; i++){
+        new (to + i) T(std::move_if_noexcept(from[i]));
+        from[i].~T();
+    }
+}
+
+template <typename T>
+void DynamicArray<T>::destroyAll(){
+    for(int i = 0; i < size; i++){
+        data[i].~T();
+    }
+    size = 0;
+}
+
+// an empty array doesn't allocate until the first element is added
+template <typename T>
 DynamicArray<T>::DynamicArray(){
-    capacity = 2;
+    capacity = 0;
     size = 0;
-    data = new T[capacity];
+    data = nullptr;
 }
 
 template <typename T>
@@ -160,52 +493,108 @@ DynamicArray<T>::DynamicArray(int capacity){
     }
     this->capacity = capacity;
     size = 0;
-    data = new T[capacity];
+    data = allocate(capacity);
 }
 
 template <typename T>
 DynamicArray<T>::DynamicArray(const DynamicArray& other){
+    capacity = other.size;  // a copy doesn't carry the unused capacity
+    size = 0;
+    data = capacity > 0 ? allocate(capacity) : nullptr;
+    for(int i = 0; i < other.size; i++){
+        new (data + i) T(other.data[i]);
+        size++;
+    }
+}
+
+template <typename T>
+DynamicArray<T>::DynamicArray(DynamicArray&& other) noexcept{
+    data = other.data;
     capacity = other.capacity;
     size = other.size;
-    data = new T[capacity];
-    std::copy(other.data, other.data + size, data);
+    other.data = nullptr;
+    other.capacity = 0;
+    other.size = 0;
 }
 
 template <typename T>
 DynamicArray<T>::~DynamicArray(){
-    delete[] data;
+    destroyAll();
+    ::operator delete(data);
 }
 
 template <typename T>
 DynamicArray<T>& DynamicArray<T>::operator=(const DynamicArray& other){
     if(this != &other){
-        delete[] data;
+        destroyAll();
+        if(capacity < other.size){
+            ::operator delete(data);
+            data = allocate(other.size);
+            capacity = other.size;
+        }
+        for(int i = 0; i < other.size; i++){
+            new (data + i) T(other.data[i]);
+            size++;
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+DynamicArray<T>& DynamicArray<T>::operator=(DynamicArray&& other) noexcept{
+    if(this != &other){
+        destroyAll();
+        ::operator delete(data);
+        data = other.data;
         capacity = other.capacity;
         size = other.size;
-        data = new T[capacity];
-        std::copy(other.data, other.data + size, data);
+        other.data = nullptr;
+        other.capacity = 0;
+        other.size = 0;
     }
     return *this;
 }
 
+// the elements are moved (not copied) to the new storage
 template <typename T>
 void DynamicArray<T>::resize(int newCapacity){
     if(newCapacity <= 0){
         throw std::invalid_argument("New capacity must be greater than 0");
     }
-    T* newData = new T[newCapacity];
-    std::copy(data, data + size, newData);
-    delete[] data;
+    T* newData = allocate(newCapacity);
+    moveElements(data, size, newData);
+    ::operator delete(data);
     data = newData;
     capacity = newCapacity;
 }
 
 template <typename T>
 void DynamicArray<T>::push_back(const T& value){
+    emplace_back(value);
+}
+
+template <typename T>
+void DynamicArray<T>::push_back(T&& value){
+    emplace_back(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+T& DynamicArray<T>::emplace_back(Args&&... args){
     if(size == capacity){
-        resize(capacity * 2);
+        int newCapacity = capacity == 0 ? 2 : capacity * 2;
+        T* newData = allocate(newCapacity);
+        // construct the new element first, args may refer to an element of the old storage
+        new (newData + size) T(std::forward<Args>(args)...);
+        moveElements(data, size, newData);
+        ::operator delete(data);
+        data = newData;
+        capacity = newCapacity;
     }
-    data[size++] = value;
+    else{
+        new (data + size) T(std::forward<Args>(args)...);
+    }
+    return data[size++];
 }
 
 template <typename T>
@@ -214,11 +603,50 @@ void DynamicArray<T>::removeAt(int index){
         throw std::out_of_range("Index out of range");
     }
     for(int i = index; i < size - 1; i++){
-        data[i] = data[i + 1];
+        data[i] = std::move(data[i + 1]);
+    }
+    data[size - 1].~T();
+    size--;
+}
+
+template <typename T>
+void DynamicArray<T>::removeAtUnordered(int index){
+    if(index < 0 || index >= size){
+        throw std::out_of_range("Index out of range");
     }
+    if(index != size - 1){
+        data[index] = std::move(data[size - 1]);
+    }
+    data[size - 1].~T();
     size--;
 }
 
+template <typename T>
+void DynamicArray<T>::reserve(int newCapacity){
+    if(newCapacity > capacity){
+        resize(newCapacity);
+    }
+}
+
+template <typename T>
+void DynamicArray<T>::shrink_to_fit(){
+    if(size == capacity){
+        return;
+    }
+    if(size == 0){
+        ::operator delete(data);
+        data = nullptr;
+        capacity = 0;
+        return;
+    }
+    resize(size);
+}
+
+template <typename T>
+void DynamicArray<T>::clear(){
+    destroyAll();
+}
+
 template <typename T>
 T& DynamicArray<T>::get(int index){
     if(index < 0 || index >= size){
@@ -232,6 +660,19 @@ int DynamicArray<T>::getSize() const{
     return size;
 }
 
+template <typename T>
+int DynamicArray<T>::getCapacity() const{
+    return capacity;
+}
+
+template <typename T>
+MemoryUsage DynamicArray<T>::memoryUsage() const{
+    MemoryUsage usage;
+    usage.used = sizeof(T) * size;
+    usage.reserved = sizeof(T) * capacity;
+    return usage;
+}
+
 template <typename T>
 bool DynamicArray<T>::isEmpty() const{
     return size == 0;
@@ -253,6 +694,26 @@ const T& DynamicArray<T>::operator[](int index) const{
     return data[index];
 }
 
+template <typename T>
+T* DynamicArray<T>::begin(){
+    return data;
+}
+
+template <typename T>
+T* DynamicArray<T>::end(){
+    return data + size;
+}
+
+template <typename T>
+const T* DynamicArray<T>::begin() const{
+    return data;
+}
+
+template <typename T>
+const T* DynamicArray<T>::end() const{
+    return data + size;
+}
+
 
 //////////////////////////////////////////
 // Pair
@@ -268,75 +729,215 @@ bool Pair<T1, T2>::operator<(const Pair<T1, T2>& other) const{
     return this->second < other.second;
 }
 
+//////////////////////////////////////////
+// Comparators
+//////////////////////////////////////////
+template <typename T1, typename T2>
+bool LessBySecond::operator()(const Pair<T1, T2>& a, const Pair<T1, T2>& b) const{
+    return a.second < b.second;
+}
+
+template <typename T1, typename T2>
+bool LessByFirst::operator()(const Pair<T1, T2>& a, const Pair<T1, T2>& b) const{
+    return a.first < b.first;
+}
+
+template <typename T1, typename T2>
+bool LessBySecondThenFirst::operator()(const Pair<T1, T2>& a, const Pair<T1, T2>& b) const{
+    if(a.second < b.second) return true;
+    if(b.second < a.second) return false;
+    return a.first < b.first;
+}
+
+template <typename Compare>
+Reverse<Compare>::Reverse(const Compare& compare) : compare(compare) {}
+
+template <typename Compare>
+template <typename T>
+bool Reverse<Compare>::operator()(const T& a, const T& b) const{
+    return compare(b, a);
+}
+
+template <typename KeyFn, typename Compare>
+KeyCompare<KeyFn, Compare>::KeyCompare(const KeyFn& key, const Compare& compare) : key(key), compare(compare) {}
+
+template <typename KeyFn, typename Compare>
+template <typename T>
+bool KeyCompare<KeyFn, Compare>::operator()(const T& a, const T& b) const{
+    return compare(key(a), key(b));
+}
+
 //////////////////////////////////////////
 // Queue
 //////////////////////////////////////////
 template <typename T>
 Queue<T>::Queue(){
+    data = nullptr;
+    capacity = 0;
     head = 0;
-    tail = 0;
     size = 0;
 }
 
 template <typename T>
-Queue<T>::~Queue(){}
+Queue<T>::Queue(const Queue& other){
+    data = nullptr;
+    capacity = 0;
+    head = 0;
+    size = 0;
+    *this = other;
+}
 
 template <typename T>
-void Queue<T>::enqueue(const T& value){
-    // If the queue is empty, initialize the structure
-    if(size == 0){
-        if(data.getSize() == 0){
-            data.push_back(value);
+Queue<T>::Queue(Queue&& other) noexcept{
+    data = other.data;
+    capacity = other.capacity;
+    head = other.head;
+    size = other.size;
+    other.data = nullptr;
+    other.capacity = 0;
+    other.head = 0;
+    other.size = 0;
+}
+
+template <typename T>
+Queue<T>::~Queue(){
+    release();
+}
+
+template <typename T>
+void Queue<T>::release(){
+    while(size > 0){
+        data[head].~T();
+        head = (head + 1) & (capacity - 1);
+        size--;
+    }
+    ::operator delete(data);
+    data = nullptr;
+    capacity = 0;
+    head = 0;
+}
+
+template <typename T>
+Queue<T>& Queue<T>::operator=(const Queue& other){
+    if(this != &other){
+        while(size > 0){
+            dequeue();
         }
-        else{
-            data[0] = value;
+        if(capacity < other.size){
+            grow(other.size);
         }
-        head = 0;
-        tail = 1;
-        size = 1;
+        for(int i = 0; i < other.size; i++){
+            enqueue(other.data[(other.head + i) & (other.capacity - 1)]);
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+Queue<T>& Queue<T>::operator=(Queue&& other) noexcept{
+    if(this != &other){
+        release();
+        data = other.data;
+        capacity = other.capacity;
+        head = other.head;
+        size = other.size;
+        other.data = nullptr;
+        other.capacity = 0;
+        other.head = 0;
+        other.size = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+void Queue<T>::grow(int minCapacity){
+    int newCapacity = capacity == 0 ? 4 : capacity;
+    while(newCapacity < minCapacity){
+        newCapacity *= 2;
+    }
+    if(newCapacity == capacity){
         return;
     }
-    
+    T* newData = static_cast<T*>(::operator new(sizeof(T) * newCapacity));
+
+    // Move all elements in the correct order, the new buffer starts at 0
+    for(int i = 0; i < size; i++){
+        T& element = data[(head + i) & (capacity - 1)];
+        new (newData + i) T(std::move_if_noexcept(element));
+        element.~T();
+    }
+    ::operator delete(data);
+    data = newData;
+    capacity = newCapacity;
+    head = 0;
+}
+
+template <typename T>
+void Queue<T>::enqueue(const T& value){
     // If the queue is full, expand it
-    if(size == data.getSize()){
-        DynamicArray<T> temp(data.getSize() * 2 + 1);  // Always add at least one element
-        
-        // Copy all elements in the correct order
-        for(int i = 0; i < size; i++){
-            temp.push_back(data[(head + i) % data.getSize()]);
-        }
-        
-        // Replace with the new array
-        data = temp;
-        head = 0;
-        tail = size;
+    if(size == capacity){
+        T copy(value);  // value may be an element of the queue
+        grow(size + 1);
+        new (data + ((head + size) & (capacity - 1))) T(std::move(copy));
     }
-    
-    // Add the new value
-    if(tail < data.getSize()){
-        data[tail] = value;
+    else{
+        new (data + ((head + size) & (capacity - 1))) T(value);
+    }
+    size++;
+}
+
+template <typename T>
+void Queue<T>::enqueue(T&& value){
+    if(size == capacity){
+        T moved(std::move(value));
+        grow(size + 1);
+        new (data + ((head + size) & (capacity - 1))) T(std::move(moved));
     }
     else{
-        data.push_back(value);
+        new (data + ((head + size) & (capacity - 1))) T(std::move(value));
     }
-    
-    tail = (tail + 1) % data.getSize();
     size++;
 }
 
+// grows at most once for the whole range
+template <typename T>
+void Queue<T>::enqueueRange(const DynamicArray<T>& values){
+    if(size + values.getSize() > capacity){
+        grow(size + values.getSize());
+    }
+    int mask = capacity - 1;
+    for(const T& value : values){
+        new (data + ((head + size) & mask)) T(value);
+        size++;
+    }
+}
+
 template <typename T>
 T Queue<T>::dequeue(){
     if(size == 0){
         throw std::out_of_range("Queue is empty");
     }
     
-    T value = data[head];
-    head = (head + 1) % data.getSize();
+    T value(std::move(data[head]));
+    data[head].~T();
+    head = (head + 1) & (capacity - 1);
     size--;
     
     return value;
 }
 
+template <typename T>
+void Queue<T>::drain(DynamicArray<T>& out){
+    out.reserve(out.getSize() + size);
+    while(size > 0){
+        out.push_back(std::move(data[head]));
+        data[head].~T();
+        head = (head + 1) & (capacity - 1);
+        size--;
+    }
+    head = 0;
+}
+
 template <typename T>
 T Queue<T>::peek(){
     if(size == 0){
@@ -364,7 +965,7 @@ void Queue<T>::printQueue() const{
     
     std::cout << "Queue contents: ";
     for(int i = 0; i < size; i++){
-        std::cout << data[(head + i) % data.getSize()] << " ";
+        std::cout << data[(head + i) & (capacity - 1)] << " ";
     }
     std::cout << std::endl;
 }
@@ -423,88 +1024,271 @@ bool Stack<T>::isEmpty() const{
 //////////////////////////////////////////
 // PriorityQueue
 //////////////////////////////////////////
-template <typename T>
-void PriorityQueue<T>::heapifyUp(int index){
+// The internal functions use the raw storage directly (no bounds checks), the indexes are always valid
+
+// move the element up until its parent is not bigger, shifting the parents down into the hole
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::heapifyUp(int index){
+    T value(std::move(heap[index]));
     while(index > 0){
-        int parent = (index - 1) / 2;
-        if(heap[index] < heap[parent]){
-            std::swap(heap[index], heap[parent]);
+        int parent = (index - 1) / Arity;
+        if(this->comparator()(value, heap[parent])){
+            heap[index] = std::move(heap[parent]);
             index = parent;
         }
         else{
             break;
         }
     }
+    heap[index] = std::move(value);
 }
 
-template <typename T>
-void PriorityQueue<T>::heapifyDown(int index){
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::heapifyDown(int index){
+    T value(std::move(heap[index]));
     while(true){
-        int left = 2 * index + 1;
-        int right = 2 * index + 2;
-        int smallest = index;
-
-        if(left < size && heap[left] < heap[smallest]){
-            smallest = left;
+        int first = Arity * index + 1;
+        if(first >= size){
+            break;
         }
-        if(right < size && heap[right] < heap[smallest]){
-            smallest = right;
+        int last = first + Arity < size ? first + Arity : size;
+        int smallest = first;
+        for(int child = first + 1; child < last; child++){
+            if(this->comparator()(heap[child], heap[smallest])){
+                smallest = child;
+            }
         }
-        if(smallest != index){
-            std::swap(heap[index], heap[smallest]);
+        if(this->comparator()(heap[smallest], value)){
+            heap[index] = std::move(heap[smallest]);
             index = smallest;
         }
         else{
             break;
         }
     }
+    heap[index] = std::move(value);
 }
 
-template <typename T>
-PriorityQueue<T>::PriorityQueue(){
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::buildHeap(){
+    if(size < 2){
+        return;
+    }
+    for(int i = (size - 2) / Arity; i >= 0; i--){
+        heapifyDown(i);
+    }
+}
+
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::grow(int minCapacity){
+    int newCapacity = capacity == 0 ? 16 : capacity;
+    while(newCapacity < minCapacity){
+        newCapacity *= 2;
+    }
+    if(newCapacity == capacity){
+        return;
+    }
+    T* newBuffer = static_cast<T*>(::operator new(sizeof(T) * (newCapacity + OFFSET), std::align_val_t(ALIGNMENT)));
+    T* newHeap = newBuffer + OFFSET;
+    for(int i = 0; i < size; i++){
+        new (newHeap + i) T(std::move_if_noexcept(heap[i]));
+        heap[i].~T();
+    }
+    if(buffer != nullptr){
+        ::operator delete(buffer, std::align_val_t(ALIGNMENT));
+    }
+    buffer = newBuffer;
+    heap = newHeap;
+    capacity = newCapacity;
+}
+
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::release(){
+    for(int i = 0; i < size; i++){
+        heap[i].~T();
+    }
+    if(buffer != nullptr){
+        ::operator delete(buffer, std::align_val_t(ALIGNMENT));
+    }
+    buffer = nullptr;
+    heap = nullptr;
+    capacity = 0;
     size = 0;
 }
 
-template <typename T>
-PriorityQueue<T>::~PriorityQueue(){}
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue() : CompareHolder<Compare>(Compare()){
+    buffer = nullptr;
+    heap = nullptr;
+    capacity = 0;
+    size = 0;
+}
 
-template <typename T>
-void PriorityQueue<T>::enqueue(const T& value){
-    heap.push_back(value);
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(const Compare& compare) : CompareHolder<Compare>(compare){
+    buffer = nullptr;
+    heap = nullptr;
+    capacity = 0;
+    size = 0;
+}
+
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(const DynamicArray<T>& values, const Compare& compare) : PriorityQueue(compare){
+    if(values.isEmpty()){
+        return;
+    }
+    grow(values.getSize());
+    for(const T& value : values){
+        new (heap + size) T(value);
+        size++;
+    }
+    buildHeap();
+}
+
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(const PriorityQueue& other) : PriorityQueue(other.comparator()){
+    *this = other;
+}
+
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(PriorityQueue&& other) noexcept : CompareHolder<Compare>(other.comparator()){
+    buffer = other.buffer;
+    heap = other.heap;
+    capacity = other.capacity;
+    size = other.size;
+    other.buffer = nullptr;
+    other.heap = nullptr;
+    other.capacity = 0;
+    other.size = 0;
+}
+
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>::~PriorityQueue(){
+    release();
+}
+
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>& PriorityQueue<T, Compare, Arity>::operator=(const PriorityQueue& other){
+    if(this != &other){
+        CompareHolder<Compare>::operator=(other);
+        for(int i = 0; i < size; i++){
+            heap[i].~T();
+        }
+        size = 0;
+        if(capacity < other.size){
+            grow(other.size);
+        }
+        for(int i = 0; i < other.size; i++){   // the order is already a valid heap
+            new (heap + i) T(other.heap[i]);
+            size++;
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, int Arity>
+PriorityQueue<T, Compare, Arity>& PriorityQueue<T, Compare, Arity>::operator=(PriorityQueue&& other) noexcept{
+    if(this != &other){
+        CompareHolder<Compare>::operator=(other);
+        release();
+        buffer = other.buffer;
+        heap = other.heap;
+        capacity = other.capacity;
+        size = other.size;
+        other.buffer = nullptr;
+        other.heap = nullptr;
+        other.capacity = 0;
+        other.size = 0;
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::enqueue(const T& value){
+    if(size == capacity){
+        T copy(value);  // value may be an element of the heap
+        grow(size + 1);
+        new (heap + size) T(std::move(copy));
+    }
+    else{
+        new (heap + size) T(value);
+    }
     size++;
     heapifyUp(size - 1);
 }
 
-template <typename T>
-T PriorityQueue<T>::dequeue(){
+/*
+Many values compared to the heap size - append them all and rebuild in O(n),
+otherwise push them one by one
+*/
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::pushRange(const DynamicArray<T>& values){
+    if(values.isEmpty()){
+        return;
+    }
+    if(size + values.getSize() > capacity){
+        grow(size + values.getSize());
+    }
+    bool rebuild = values.getSize() > size;
+    for(const T& value : values){
+        new (heap + size) T(value);
+        size++;
+        if(!rebuild){
+            heapifyUp(size - 1);
+        }
+    }
+    if(rebuild){
+        buildHeap();
+    }
+}
+
+template <typename T, typename Compare, int Arity>
+T PriorityQueue<T, Compare, Arity>::dequeue(){
     if(size == 0){
         throw std::out_of_range("PriorityQueue is empty");
     }
-    T top = heap[0];
-    heap[0] = heap[size - 1];
-    heap.removeAt(size - 1);
+    T top(std::move(heap[0]));
     size--;
+    if(size > 0){
+        heap[0] = std::move(heap[size]);
+    }
+    heap[size].~T();
     if(size > 0){
         heapifyDown(0);
     }
     return top;
 }
 
-template <typename T>
-const T& PriorityQueue<T>::peek() const{
+template <typename T, typename Compare, int Arity>
+const T& PriorityQueue<T, Compare, Arity>::peek() const{
     if(size == 0){
         throw std::out_of_range("PriorityQueue is empty");
     }
     return heap[0];
 }
 
-template <typename T>
-int PriorityQueue<T>::getSize() const {return size;}
-template <typename T>
-bool PriorityQueue<T>::isEmpty() const{return size == 0;}
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::reserve(int newCapacity){
+    if(newCapacity > capacity){
+        grow(newCapacity);
+    }
+}
 
-template <typename T>
-void PriorityQueue<T>::printHeap() const{
+template <typename T, typename Compare, int Arity>
+int PriorityQueue<T, Compare, Arity>::getSize() const {return size;}
+template <typename T, typename Compare, int Arity>
+bool PriorityQueue<T, Compare, Arity>::isEmpty() const{return size == 0;}
+
+template <typename T, typename Compare, int Arity>
+MemoryUsage PriorityQueue<T, Compare, Arity>::memoryUsage() const{
+    MemoryUsage usage;
+    usage.used = sizeof(T) * size;
+    usage.reserved = buffer == nullptr ? 0 : sizeof(T) * (capacity + OFFSET);
+    return usage;
+}
+
+template <typename T, typename Compare, int Arity>
+void PriorityQueue<T, Compare, Arity>::printHeap() const{
     if(size == 0){
         std::cout << "Heap is empty" << std::endl;
         return;
@@ -566,6 +1350,494 @@ bool DisjointSet<T>::isSameSet(T x, T y){
     return find(x) == find(y);
 }
 
+template <typename T>
+MemoryUsage DisjointSet<T>::memoryUsage() const{
+    MemoryUsage usage = parent.memoryUsage();
+    usage += rank.memoryUsage();
+    return usage;
+}
+
+//////////////////////////////////////////
+// VisitedSet
+//////////////////////////////////////////
+template <typename Stamp>
+VisitedSet<Stamp>::VisitedSet(){
+    epoch = 0;
+}
+
+template <typename Stamp>
+void VisitedSet<Stamp>::reset(int n){
+    if(n > stamps.getSize()){
+        stamps.reserve(n);
+        while(stamps.getSize() < n){
+            stamps.push_back(0);
+        }
+    }
+    epoch++;
+    if(epoch == 0){     // wrapped around, old stamps could match the new epochs
+        for(int i = 0; i < stamps.getSize(); i++){
+            stamps[i] = 0;
+        }
+        epoch = 1;
+    }
+}
+
+template <typename Stamp>
+bool VisitedSet<Stamp>::visit(int index){
+    if(stamps[index] == epoch){
+        return false;
+    }
+    stamps[index] = epoch;
+    return true;
+}
+
+template <typename Stamp>
+bool VisitedSet<Stamp>::isVisited(int index) const{
+    return stamps[index] == epoch;
+}
+
+template <typename Stamp>
+int VisitedSet<Stamp>::getSize() const{
+    return stamps.getSize();
+}
+
+template <typename Stamp>
+MemoryUsage VisitedSet<Stamp>::memoryUsage() const{
+    return stamps.memoryUsage();
+}
+
+
+//////////////////////////////////////////
+// ArrayView
+//////////////////////////////////////////
+template <typename T>
+ArrayView<T>::ArrayView(const T* data, int size){
+    this->data = data;
+    this->size = size;
+}
+
+template <typename T>
+int ArrayView<T>::getSize() const{
+    return size;
+}
+
+template <typename T>
+bool ArrayView<T>::isEmpty() const{
+    return size == 0;
+}
+
+template <typename T>
+const T& ArrayView<T>::operator[](int index) const{
+    if(index < 0 || index >= size){
+        throw std::out_of_range("Index out of range");
+    }
+    return data[index];
+}
+
+template <typename T>
+const T* ArrayView<T>::begin() const{
+    return data;
+}
+
+template <typename T>
+const T* ArrayView<T>::end() const{
+    return data + size;
+}
+
+//////////////////////////////////////////
+// SlabArena
+//////////////////////////////////////////
+template <typename T>
+SlabArena<T>::SlabArena(){
+    static_assert(std::is_trivially_copyable<T>::value, "SlabArena elements must be trivially copyable");
+    slabs = nullptr;
+    for(int i = 0; i < NUM_CLASSES; i++){
+        freeLists[i] = nullptr;
+    }
+    nextSlabSize = MIN_SLAB;
+    reservedBytes = 0;
+}
+
+template <typename T>
+SlabArena<T>::~SlabArena(){
+    clear();
+}
+
+// the slabs move with the arena, so blocks handed out before the move stay valid
+template <typename T>
+SlabArena<T>::SlabArena(SlabArena&& other) noexcept{
+    slabs = other.slabs;
+    for(int i = 0; i < NUM_CLASSES; i++){
+        freeLists[i] = other.freeLists[i];
+        other.freeLists[i] = nullptr;
+    }
+    nextSlabSize = other.nextSlabSize;
+    reservedBytes = other.reservedBytes;
+    other.slabs = nullptr;
+    other.nextSlabSize = MIN_SLAB;
+    other.reservedBytes = 0;
+}
+
+template <typename T>
+SlabArena<T>& SlabArena<T>::operator=(SlabArena&& other) noexcept{
+    if(this != &other){
+        clear();
+        slabs = other.slabs;
+        for(int i = 0; i < NUM_CLASSES; i++){
+            freeLists[i] = other.freeLists[i];
+            other.freeLists[i] = nullptr;
+        }
+        nextSlabSize = other.nextSlabSize;
+        reservedBytes = other.reservedBytes;
+        other.slabs = nullptr;
+        other.nextSlabSize = MIN_SLAB;
+        other.reservedBytes = 0;
+    }
+    return *this;
+}
+
+// log2 of the block size
+template <typename T>
+int SlabArena<T>::sizeClass(int count){
+    int k = 0;
+    while((1 << k) < count){
+        k++;
+    }
+    // a released block must be big enough to hold the free list pointer
+    while(sizeof(T) * ((size_t)1 << k) < sizeof(T*)){
+        k++;
+    }
+    return k;
+}
+
+template <typename T>
+int SlabArena<T>::blockSize(int count){
+    return 1 << sizeClass(count);
+}
+
+template <typename T>
+void SlabArena<T>::addSlab(size_t minElements){
+    size_t elements = std::max(nextSlabSize, minElements);
+    Slab* slab = static_cast<Slab*>(::operator new(sizeof(Slab) + elements * sizeof(T)));
+    slab->next = slabs;
+    slab->capacity = elements;
+    slab->used = 0;
+    slabs = slab;
+    reservedBytes += sizeof(Slab) + elements * sizeof(T);
+    if(nextSlabSize < MAX_SLAB){
+        nextSlabSize *= 2;
+    }
+}
+
+template <typename T>
+void SlabArena<T>::reserve(size_t elements){
+    if(slabs == nullptr || slabs->capacity - slabs->used < elements){
+        addSlab(elements);
+    }
+}
+
+template <typename T>
+T* SlabArena<T>::allocate(int count){
+    int k = sizeClass(count);
+    if(freeLists[k] != nullptr){
+        T* block = freeLists[k];
+        std::memcpy(&freeLists[k], static_cast<void*>(block), sizeof(T*));  // the next free block is stored inside the block
+        return block;
+    }
+    size_t elements = (size_t)1 << k;
+    if(slabs == nullptr || slabs->capacity - slabs->used < elements){
+        addSlab(elements);
+    }
+    T* block = reinterpret_cast<T*>(slabs + 1) + slabs->used;
+    slabs->used += elements;
+    return block;
+}
+
+template <typename T>
+void SlabArena<T>::release(T* block, int count){
+    if(block == nullptr){
+        return;
+    }
+    int k = sizeClass(count);
+    std::memcpy(static_cast<void*>(block), &freeLists[k], sizeof(T*));
+    freeLists[k] = block;
+}
+
+template <typename T>
+void SlabArena<T>::clear(){
+    while(slabs != nullptr){
+        Slab* next = slabs->next;
+        ::operator delete(slabs);
+        slabs = next;
+    }
+    for(int i = 0; i < NUM_CLASSES; i++){
+        freeLists[i] = nullptr;
+    }
+    nextSlabSize = MIN_SLAB;
+    reservedBytes = 0;
+}
+
+template <typename T>
+size_t SlabArena<T>::getReservedBytes() const{
+    return reservedBytes;
+}
+
+//////////////////////////////////////////
+// ArenaList
+//////////////////////////////////////////
+template <typename T>
+ArenaList<T>::ArenaList(){
+    data = nullptr;
+    size = 0;
+    capacity = 0;
+}
+
+template <typename T>
+void ArenaList<T>::push_back(const T& value, SlabArena<T>& arena){
+    if(size == capacity){
+        int newCapacity = SlabArena<T>::blockSize(capacity == 0 ? 2 : capacity * 2);
+        T* newData = arena.allocate(newCapacity);
+        std::copy(data, data + size, newData);
+        arena.release(data, capacity);
+        data = newData;
+        capacity = newCapacity;
+    }
+    data[size++] = value;
+}
+
+template <typename T>
+void ArenaList<T>::assign(const T* values, int count, SlabArena<T>& arena){
+    if(count > capacity){
+        arena.release(data, capacity);
+        capacity = SlabArena<T>::blockSize(count);
+        data = arena.allocate(capacity);
+    }
+    std::copy(values, values + count, data);
+    size = count;
+}
+
+template <typename T>
+void ArenaList<T>::reserve(int newCapacity, SlabArena<T>& arena){
+    if(newCapacity <= capacity){
+        return;
+    }
+    newCapacity = SlabArena<T>::blockSize(newCapacity);
+    T* newData = arena.allocate(newCapacity);
+    std::copy(data, data + size, newData);
+    arena.release(data, capacity);
+    data = newData;
+    capacity = newCapacity;
+}
+
+template <typename T>
+void ArenaList<T>::removeAt(int index){
+    if(index < 0 || index >= size){
+        throw std::out_of_range("Index out of range");
+    }
+    for(int i = index; i < size - 1; i++){
+        data[i] = data[i + 1];
+    }
+    size--;
+}
+
+template <typename T>
+void ArenaList<T>::removeAtUnordered(int index){
+    if(index < 0 || index >= size){
+        throw std::out_of_range("Index out of range");
+    }
+    data[index] = data[size - 1];
+    size--;
+}
+
+template <typename T>
+void ArenaList<T>::truncate(int newSize){
+    if(newSize < 0 || newSize > size){
+        throw std::out_of_range("Index out of range");
+    }
+    size = newSize;
+}
+
+template <typename T>
+T& ArenaList<T>::get(int index){
+    if(index < 0 || index >= size){
+        throw std::out_of_range("Index out of range");
+    }
+    return data[index];
+}
+
+template <typename T>
+const T& ArenaList<T>::get(int index) const{
+    if(index < 0 || index >= size){
+        throw std::out_of_range("Index out of range");
+    }
+    return data[index];
+}
+
+template <typename T>
+int ArenaList<T>::getSize() const{
+    return size;
+}
+
+template <typename T>
+bool ArenaList<T>::isEmpty() const{
+    return size == 0;
+}
+
+template <typename T>
+ArrayView<T> ArenaList<T>::view() const{
+    return ArrayView<T>(data, size);
+}
+
+template <typename T>
+T* ArenaList<T>::begin(){
+    return data;
+}
+
+template <typename T>
+T* ArenaList<T>::end(){
+    return data + size;
+}
+
+template <typename T>
+const T* ArenaList<T>::begin() const{
+    return data;
+}
+
+template <typename T>
+const T* ArenaList<T>::end() const{
+    return data + size;
+}
+
+//////////////////////////////////////////
+// MPMCQueue
+//////////////////////////////////////////
+template <typename T>
+T* MPMCQueue<T>::Slot::value(){
+    return std::launder(reinterpret_cast<T*>(storage));
+}
+
+template <typename T>
+MPMCQueue<T>::MPMCQueue(std::size_t capacity){
+    if(capacity < 2){
+        capacity = 2;
+    }
+    std::size_t rounded = 1;
+    while(rounded < capacity){
+        rounded <<= 1;
+    }
+    slots = static_cast<Slot*>(::operator new(sizeof(Slot) * rounded, std::align_val_t(alignof(Slot))));
+    for(std::size_t i = 0; i < rounded; i++){
+        new (&slots[i].sequence) std::atomic<std::size_t>(i);
+    }
+    mask = rounded - 1;
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+// no other thread may use the queue while it is destroyed
+template <typename T>
+MPMCQueue<T>::~MPMCQueue(){
+    T leftover;
+    while(tryDequeue(leftover)){}
+    for(std::size_t i = 0; i <= mask; i++){
+        slots[i].sequence.~atomic();
+    }
+    ::operator delete(slots, std::align_val_t(alignof(Slot)));
+}
+
+template <typename T>
+template <typename U>
+bool MPMCQueue<T>::push(U&& value){
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while(true){
+        Slot& slot = slots[pos & mask];
+        std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = (std::ptrdiff_t)sequence - (std::ptrdiff_t)pos;
+        if(diff == 0){
+            // the slot is free, try to claim the position (pos is reloaded on failure)
+            if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                new (slot.storage) T(std::forward<U>(value));
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(diff < 0){
+            return false;   // the consumer of the previous round didn't take the value yet - full
+        }
+        else{
+            pos = enqueuePos.load(std::memory_order_relaxed);  // another producer took the position
+        }
+    }
+}
+
+template <typename T>
+bool MPMCQueue<T>::tryEnqueue(const T& value){
+    return push(value);
+}
+
+template <typename T>
+bool MPMCQueue<T>::tryEnqueue(T&& value){
+    return push(std::move(value));
+}
+
+template <typename T>
+bool MPMCQueue<T>::tryDequeue(T& out){
+    std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    while(true){
+        Slot& slot = slots[pos & mask];
+        std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = (std::ptrdiff_t)sequence - (std::ptrdiff_t)(pos + 1);
+        if(diff == 0){
+            if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                T* value = slot.value();
+                out = std::move(*value);
+                value->~T();
+                // free the slot for the producer of the next round
+                slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(diff < 0){
+            return false;   // the producer of this position didn't write yet - empty
+        }
+        else{
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+void MPMCQueue<T>::enqueue(const T& value){
+    while(!push(value)){
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+T MPMCQueue<T>::dequeue(){
+    T value;
+    while(!tryDequeue(value)){
+        std::this_thread::yield();
+    }
+    return value;
+}
+
+template <typename T>
+std::size_t MPMCQueue<T>::getCapacity() const{
+    return mask + 1;
+}
+
+template <typename T>
+std::size_t MPMCQueue<T>::approxSize() const{
+    std::size_t tail = enqueuePos.load(std::memory_order_acquire);
+    std::size_t head = dequeuePos.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+}
+
+template <typename T>
+bool MPMCQueue<T>::isEmpty() const{
+    return approxSize() == 0;
+}
 
 }  // namespace graph
 
@@ -578,4 +1850,6 @@ template class graph::DynamicArray<graph::Pair<graph::Pair<int, int>, int>>;  //
 template class graph::Queue<int>;
 template class graph::Stack<int>;
 template class graph::PriorityQueue<graph::Pair<int, int>>; // For Dijkstra's algorithm
-template class graph::DisjointSet<int>;
\ No newline at end of file
+template class graph::DisjointSet<int>;
+template class graph::MPMCQueue<int>;
+template class graph::VisitedSet<uint32_t>;
@@ -0,0 +1,255 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "ExternalMemory.hpp"
+
+using namespace graph;
+
+//////////////////////////////////////////
+// EdgeScanner
+//////////////////////////////////////////
+/*
+Sequential passes over the records of a binary edge file with one block buffer.
+Every record is checked against the header before it is handed on.
+*/
+template <typename V, typename W>
+class EdgeScanner {
+private:
+    static const std::size_t RECORD_SIZE = 2 * sizeof(V) + sizeof(W);
+
+    std::istream& in;
+    BinaryHeader header;
+    std::streampos firstRecord;
+    char* block;
+    std::size_t blockRecords;
+
+public:
+    EdgeScanner(std::istream& in, const BinaryHeader& header, std::size_t blockBytes) : in(in), header(header){
+        firstRecord = in.tellg();
+        blockRecords = blockBytes / RECORD_SIZE > 0 ? blockBytes / RECORD_SIZE : 1;
+        block = new char[blockRecords * RECORD_SIZE];
+    }
+
+    ~EdgeScanner(){
+        delete[] block;
+    }
+
+    EdgeScanner(const EdgeScanner& other) = delete;
+    EdgeScanner& operator=(const EdgeScanner& other) = delete;
+
+    V getNumOfVertices() const{
+        return (V)header.numOfVertices;
+    }
+
+    // calls onEdge(src, dest, weight) for every record, in file order
+    template <typename F>
+    void pass(ExternalStats* stats, F&& onEdge){
+        in.clear();
+        in.seekg(firstRecord);
+        uint64_t remaining = header.numOfEdges;
+        while(remaining > 0){
+            std::size_t count = remaining < blockRecords ? (std::size_t)remaining : blockRecords;
+            in.read(block, count * RECORD_SIZE);
+            if((std::size_t)in.gcount() != count * RECORD_SIZE){
+                throw std::invalid_argument("Unexpected end of the graph binary file.");
+            }
+            const char* record = block;
+            for(std::size_t i = 0; i < count; i++){
+                V src;
+                V dest;
+                W weight;
+                std::memcpy(&src, record, sizeof(V));
+                std::memcpy(&dest, record + sizeof(V), sizeof(V));
+                std::memcpy(&weight, record + 2 * sizeof(V), sizeof(W));
+                record += RECORD_SIZE;
+                if(src < 1 || (uint64_t)src > header.numOfVertices || dest < 1 || (uint64_t)dest > header.numOfVertices){
+                    throw std::invalid_argument("Corrupted graph binary file.");
+                }
+                onEdge(src, dest, weight);
+            }
+            remaining -= count;
+        }
+        if(stats != nullptr){
+            stats->passes++;
+            stats->bytesRead += header.numOfEdges * RECORD_SIZE;
+        }
+    }
+};
+
+static std::ifstream openBinaryInput(const std::string& path){
+    std::ifstream file(path, std::ios::binary);
+    if(!file){
+        throw std::invalid_argument("Cannot open the file " + path + ".");
+    }
+    return file;
+}
+
+//////////////////////////////////////////
+// externalBfs
+//////////////////////////////////////////
+template <typename G>
+DynamicArray<int> graph::externalBfs(std::istream& in, typename G::vertex_type source, ExternalStats* stats, std::size_t blockBytes){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    EdgeScanner<V, W> scanner(in, readBinaryHeader<G>(in), blockBytes);
+    V n = scanner.getNumOfVertices();
+    if(source < 1 || source > n){
+        throw std::invalid_argument("Invalid source vertex.");
+    }
+
+    DynamicArray<int> dist(n > 0 ? n : 1);
+    for(V i = 0; i < n; i++){
+        dist.push_back(-1);
+    }
+    int* hops = dist.begin();   // no bounds checks in the scan, the scanner checked the ids
+    hops[source - 1] = 0;
+    bool changed = true;
+    while(changed){
+        changed = false;
+        scanner.pass(stats, [hops, &changed](V src, V dest, W){
+            int through = hops[src - 1];
+            if(through >= 0 && (hops[dest - 1] < 0 || hops[dest - 1] > through + 1)){
+                hops[dest - 1] = through + 1;
+                changed = true;
+            }
+        });
+    }
+    return dist;
+}
+
+template <typename G>
+DynamicArray<int> graph::externalBfs(const std::string& path, typename G::vertex_type source, ExternalStats* stats, std::size_t blockBytes){
+    std::ifstream file = openBinaryInput(path);
+    return externalBfs<G>(file, source, stats, blockBytes);
+}
+
+//////////////////////////////////////////
+// externalConnectedComponents
+//////////////////////////////////////////
+template <typename G>
+DynamicArray<typename G::vertex_type> graph::externalConnectedComponents(std::istream& in, ExternalStats* stats, std::size_t blockBytes){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    EdgeScanner<V, W> scanner(in, readBinaryHeader<G>(in), blockBytes);
+    V n = scanner.getNumOfVertices();
+
+    DisjointSet<V> components(n + 1);   // +1 because vertices are 1-indexed
+    scanner.pass(stats, [&components](V src, V dest, W){
+        components.unionSets(src, dest);
+    });
+
+    // the smallest id of every component is the first one seen in increasing order
+    DynamicArray<V> smallest(n + 1);
+    for(V i = 0; i <= n; i++){
+        smallest.push_back(0);
+    }
+    DynamicArray<V> labels(n > 0 ? n : 1);
+    for(V v = 1; v <= n; v++){
+        V root = components.find(v);
+        if(smallest[root] == 0){
+            smallest[root] = v;
+        }
+        labels.push_back(smallest[root]);
+    }
+    return labels;
+}
+
+template <typename G>
+DynamicArray<typename G::vertex_type> graph::externalConnectedComponents(const std::string& path, ExternalStats* stats, std::size_t blockBytes){
+    std::ifstream file = openBinaryInput(path);
+    return externalConnectedComponents<G>(file, stats, blockBytes);
+}
+
+//////////////////////////////////////////
+// readCompressed
+//////////////////////////////////////////
+/*
+Two passes: the first checks that the records are grouped by source in increasing order and whether all the
+weights are 1, the second collects the records of one source at a time and hands them to the builder
+*/
+template <typename G>
+BasicCompressedGraph<typename G::vertex_type, typename G::weight_type> graph::readCompressed(std::istream& in, ExternalStats* stats,
+                                                                                           std::size_t blockBytes){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    EdgeScanner<V, W> scanner(in, readBinaryHeader<G>(in), blockBytes);
+
+    V last = 0;
+    bool grouped = true;
+    bool unitWeights = true;
+    scanner.pass(stats, [&last, &grouped, &unitWeights](V src, V, W weight){
+        if(src < last) grouped = false;
+        if(weight != W(1)) unitWeights = false;
+        last = src;
+    });
+    if(!grouped){
+        throw std::invalid_argument("The records of the graph binary file are not grouped by source.");
+    }
+
+    BasicCompressedGraphBuilder<V, W> builder(scanner.getNumOfVertices(), unitWeights);
+    DynamicArray<Pair<V, W>> list;
+    V current = 0;
+    scanner.pass(stats, [&builder, &list, &current](V src, V dest, W weight){
+        if(src != current){
+            if(!list.isEmpty()) builder.addList(current, list.begin(), list.getSize());
+            list.clear();
+            current = src;
+        }
+        list.push_back(Pair<V, W>(dest, weight));
+    });
+    if(!list.isEmpty()){
+        builder.addList(current, list.begin(), list.getSize());
+    }
+    return builder.finish();
+}
+
+template <typename G>
+BasicCompressedGraph<typename G::vertex_type, typename G::weight_type> graph::readCompressed(const std::string& path, ExternalStats* stats,
+                                                                                           std::size_t blockBytes){
+    std::ifstream file = openBinaryInput(path);
+    return readCompressed<G>(file, stats, blockBytes);
+}
+
+// The same graph types as readBinary
+#define INSTANTIATE_EXTERNAL(G) \
+    template DynamicArray<int> graph::externalBfs<G>(std::istream& in, typename G::vertex_type source, ExternalStats* stats, \
+                                                     std::size_t blockBytes); \
+    template DynamicArray<int> graph::externalBfs<G>(const std::string& path, typename G::vertex_type source, ExternalStats* stats, \
+                                                     std::size_t blockBytes); \
+    template DynamicArray<typename G::vertex_type> graph::externalConnectedComponents<G>(std::istream& in, ExternalStats* stats, \
+                                                     std::size_t blockBytes); \
+    template DynamicArray<typename G::vertex_type> graph::externalConnectedComponents<G>(const std::string& path, ExternalStats* stats, \
+                                                     std::size_t blockBytes);
+
+using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+using GraphF32 = BasicGraph<uint32_t, float>;
+using GraphI64 = BasicGraph<uint32_t, int64_t>;
+using UnweightedGraphU32 = BasicGraph<uint32_t, uint32_t, Unweighted>;
+
+INSTANTIATE_EXTERNAL(Graph)
+INSTANTIATE_EXTERNAL(GraphU8)
+INSTANTIATE_EXTERNAL(GraphF32)
+INSTANTIATE_EXTERNAL(GraphI64)
+INSTANTIATE_EXTERNAL(UnweightedGraph)
+INSTANTIATE_EXTERNAL(UnweightedGraphU32)
+
+// The vertex and weight types of BasicCompressedGraph
+#define INSTANTIATE_COMPRESSED_READER(G) \
+    template BasicCompressedGraph<typename G::vertex_type, typename G::weight_type> graph::readCompressed<G>(std::istream& in, \
+                                                     ExternalStats* stats, std::size_t blockBytes); \
+    template BasicCompressedGraph<typename G::vertex_type, typename G::weight_type> graph::readCompressed<G>(const std::string& path, \
+                                                     ExternalStats* stats, std::size_t blockBytes);
+
+INSTANTIATE_COMPRESSED_READER(Graph)
+INSTANTIATE_COMPRESSED_READER(GraphU8)
+INSTANTIATE_COMPRESSED_READER(GraphF32)
+INSTANTIATE_COMPRESSED_READER(GraphI64)
+INSTANTIATE_COMPRESSED_READER(UnweightedGraph)
+
+#undef INSTANTIATE_EXTERNAL
+#undef INSTANTIATE_COMPRESSED_READER
@@ -0,0 +1,69 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "GraphIO.hpp"
+#include "CompressedGraph.hpp"
+
+namespace graph {
+
+    /*
+    Semi-external algorithms for graphs that don't fit in memory as a Graph.
+    They read the binary edge file of writeBinary (GraphIO.hpp) directly: only O(V) state is kept in memory,
+    and the edges are streamed in sequential passes over the file, in blocks of blockBytes.
+    G is only used for the vertex and weight types of the file (like readBinary<G>).
+    The stream must be seekable, every pass starts again at the first record.
+    A bad or truncated file throws std::invalid_argument, like readBinary.
+    */
+
+    struct ExternalStats{
+        int passes = 0;             // full scans of the edge records
+        uint64_t bytesRead = 0;
+    };
+
+    /*
+    Hop distances from source, dist[v - 1] (-1 if v is unreachable), following the directed records.
+    Every pass relaxes all the edges in file order, so a path along increasing ids is found in one pass;
+    the passes stop when one of them changes nothing (at most the depth of the BFS tree + 1 passes).
+    */
+    template <typename G>
+    DynamicArray<int> externalBfs(std::istream& in, typename G::vertex_type source, ExternalStats* stats = nullptr,
+                                  std::size_t blockBytes = 4 << 20);
+    template <typename G>
+    DynamicArray<int> externalBfs(const std::string& path, typename G::vertex_type source, ExternalStats* stats = nullptr,
+                                  std::size_t blockBytes = 4 << 20);
+
+    /*
+    Connected components, ignoring the edge directions: labels[v - 1] is the smallest vertex id in the component of v.
+    One pass - every record is a union in a DisjointSet of the vertices.
+    */
+    template <typename G>
+    DynamicArray<typename G::vertex_type> externalConnectedComponents(std::istream& in, ExternalStats* stats = nullptr,
+                                                                      std::size_t blockBytes = 4 << 20);
+    template <typename G>
+    DynamicArray<typename G::vertex_type> externalConnectedComponents(const std::string& path, ExternalStats* stats = nullptr,
+                                                                      std::size_t blockBytes = 4 << 20);
+
+    /*
+    A BasicCompressedGraph straight from the file, the uncompressed graph never exists in memory:
+    two passes, only the encoded lists and the records of one source are kept (see BasicCompressedGraphBuilder).
+    The records must be grouped by source in increasing order, like the files of writeBinary; a file that is not
+    grouped, or has an invalid or repeated edge, throws std::invalid_argument.
+    The weights are not stored when all of them are 1. G gives the types, e.g. readCompressed<Graph> is a CompressedGraph.
+    */
+    template <typename G>
+    BasicCompressedGraph<typename G::vertex_type, typename G::weight_type> readCompressed(std::istream& in, ExternalStats* stats = nullptr,
+                                                                                         std::size_t blockBytes = 4 << 20);
+    template <typename G>
+    BasicCompressedGraph<typename G::vertex_type, typename G::weight_type> readCompressed(const std::string& path,
+                                                                                         ExternalStats* stats = nullptr,
+                                                                                         std::size_t blockBytes = 4 << 20);
+
+}  // namespace graph
@@ -0,0 +1,510 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Generators.hpp"
+
+using namespace graph;
+
+static const long CHUNK = 1 << 16;     // edges / points / rows of vertices generated by one random stream
+
+// salts of the independent random streams made from one seed
+static const uint64_t EDGE_STREAM = 0x1000;
+static const uint64_t WEIGHT_STREAM = 0x2000;
+static const uint64_t PERMUTATION_STREAM = 0x3000;
+
+//////////////////////////////////////////
+// Random
+//////////////////////////////////////////
+// splitmix64 - tiny state, so every chunk (or row) can have its own stream
+class Random {
+private:
+    uint64_t state;
+
+public:
+    Random(uint64_t seed, uint64_t stream, uint64_t index){
+        state = seed ^ (stream * 0xD1B54A32D192ED03ull) ^ (index * 0x9E3779B97F4A7C15ull);
+        next();
+    }
+
+    uint64_t next(){
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)
+    double uniform(){
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // [0, bound)
+    uint64_t below(uint64_t bound){
+        return next() % bound;
+    }
+};
+
+template <typename G>
+using EdgeOf = Pair<Pair<typename G::vertex_type, typename G::vertex_type>, typename G::weight_type>;
+
+// a weight in [minWeight, maxWeight] at the given fraction of the range
+template <typename G>
+static typename G::weight_type weightAt(double fraction, const GeneratorOptions& options){
+    using W = typename G::weight_type;
+    if constexpr(std::is_same<typename G::policy_type, Unweighted>::value){
+        (void)fraction;
+        (void)options;
+        return W(1);
+    }
+    else if constexpr(std::is_floating_point<W>::value){
+        return (W)(options.minWeight + fraction * (options.maxWeight - options.minWeight));
+    }
+    else{
+        long long low = std::llround(options.minWeight);
+        long long high = std::llround(options.maxWeight);
+        long long value = low + (long long)(fraction * (double)(high - low + 1));
+        return (W)(value > high ? high : value);
+    }
+}
+
+template <typename G>
+static typename G::weight_type randomWeight(Random& random, const GeneratorOptions& options){
+    return weightAt<G>(random.uniform(), options);
+}
+
+// f(chunk) for every chunk, on the pool when there is one
+template <typename F>
+static void forChunks(long chunks, ThreadPool* pool, F f){
+    if(pool != nullptr){
+        pool->parallel_for(0, chunks, f, 1);
+    }
+    else{
+        for(long c = 0; c < chunks; c++){
+            f(c);
+        }
+    }
+}
+
+template <typename Edge>
+static bool byEndpoints(const Edge& a, const Edge& b){
+    if(a.first.first != b.first.first) return a.first.first < b.first.first;
+    return a.first.second < b.first.second;
+}
+
+// the edges are merged in one DynamicArray (int size), where an undirected edge is stored twice
+static void checkEdgeCount(long long edges, const GeneratorOptions& options){
+    if(edges > std::numeric_limits<int>::max() / (options.directed ? 1 : 2)){
+        throw std::invalid_argument("Too many edges for the generator.");
+    }
+}
+
+/*
+Merge the chunks into the graph:
+self loops are dropped, undirected edges are stored as (smaller, bigger), duplicates are merged after a sort
+and the undirected edges are added in both directions without any duplicate scan
+*/
+template <typename G>
+static G buildGraph(typename G::vertex_type n, DynamicArray<DynamicArray<EdgeOf<G>>>& parts, const GeneratorOptions& options){
+    using V = typename G::vertex_type;
+    using Edge = EdgeOf<G>;
+    long long total = 0;
+    for(const DynamicArray<Edge>& part : parts){
+        total += part.getSize();
+    }
+    checkEdgeCount(total, options);
+    DynamicArray<Edge> edges;
+    edges.reserve((int)total);
+    for(DynamicArray<Edge>& part : parts){
+        for(Edge& edge : part){
+            V src = edge.first.first;
+            V dest = edge.first.second;
+            if(src == dest) continue;
+            if(!options.directed && dest < src){
+                edge.first.first = dest;
+                edge.first.second = src;
+            }
+            edges.push_back(edge);
+        }
+        part.clear();
+        part.shrink_to_fit();
+    }
+
+    std::sort(edges.begin(), edges.end(), byEndpoints<Edge>);
+    int unique = 0;
+    for(int i = 0; i < edges.getSize(); i++){
+        if(unique > 0 && edges[unique - 1].first.first == edges[i].first.first && edges[unique - 1].first.second == edges[i].first.second){
+            continue;
+        }
+        edges[unique++] = edges[i];
+    }
+    while(edges.getSize() > unique){
+        edges.removeAt(edges.getSize() - 1);
+    }
+
+    if(!options.directed){
+        edges.reserve(unique * 2);
+        for(int i = 0; i < unique; i++){
+            Edge reverse = edges[i];
+            reverse.first.first = edges[i].first.second;
+            reverse.first.second = edges[i].first.first;
+            edges.push_back(reverse);
+        }
+    }
+
+    G g(n);
+    g.appendUniqueEdges(edges);
+    return g;
+}
+
+template <typename G>
+static DynamicArray<DynamicArray<EdgeOf<G>>> makeParts(long chunks){
+    DynamicArray<DynamicArray<EdgeOf<G>>> parts;
+    parts.reserve((int)chunks);
+    for(long c = 0; c < chunks; c++){
+        parts.emplace_back();
+    }
+    return parts;
+}
+
+//////////////////////////////////////////
+// R-MAT
+//////////////////////////////////////////
+/*
+Every edge picks one of the 4 quadrants of the adjacency matrix scale times (a, b, c, d),
+which gives the skewed (power law like) degrees of real graphs
+*/
+template <typename G>
+G graph::rmat(int scale, int edgeFactor, const GeneratorOptions& options, const RmatParams& params){
+    using V = typename G::vertex_type;
+    if(scale < 1 || scale > 30 || edgeFactor < 1){
+        throw std::invalid_argument("Invalid R-MAT size.");
+    }
+    if(params.a < 0 || params.b < 0 || params.c < 0 || params.a + params.b + params.c > 1){
+        throw std::invalid_argument("Invalid R-MAT probabilities.");
+    }
+    long n = 1L << scale;
+    long m = n * edgeFactor;
+    checkEdgeCount(m, options);
+
+    DynamicArray<V> permutation(n);
+    for(long i = 0; i < n; i++){
+        permutation.push_back((V)(i + 1));
+    }
+    if(params.permute){
+        Random random(options.seed, PERMUTATION_STREAM, 0);
+        for(long i = n - 1; i > 0; i--){
+            long j = (long)random.below(i + 1);
+            std::swap(permutation[i], permutation[j]);
+        }
+    }
+
+    long chunks = (m + CHUNK - 1) / CHUNK;
+    DynamicArray<DynamicArray<EdgeOf<G>>> parts = makeParts<G>(chunks);
+    double ab = params.a + params.b;
+    double abc = ab + params.c;
+    forChunks(chunks, options.pool, [&](long c){
+        Random random(options.seed, EDGE_STREAM, c);
+        long count = c + 1 < chunks ? CHUNK : m - c * CHUNK;
+        DynamicArray<EdgeOf<G>>& part = parts[c];
+        part.reserve(count);
+        for(long e = 0; e < count; e++){
+            long src = 0;
+            long dest = 0;
+            for(int level = 0; level < scale; level++){
+                double r = random.uniform();
+                src <<= 1;
+                dest <<= 1;
+                if(r < params.a){
+                    // top left
+                }
+                else if(r < ab){
+                    dest |= 1;
+                }
+                else if(r < abc){
+                    src |= 1;
+                }
+                else{
+                    src |= 1;
+                    dest |= 1;
+                }
+            }
+            part.push_back(EdgeOf<G>({permutation[src], permutation[dest]}, randomWeight<G>(random, options)));
+        }
+    });
+    return buildGraph<G>((V)n, parts, options);
+}
+
+//////////////////////////////////////////
+// G(n, p)
+//////////////////////////////////////////
+/*
+Batagelj-Brandes skipping: the gap to the next edge of a row is geometric,
+so only the edges are visited and not all the n^2 pairs. Every row has its own random stream.
+*/
+template <typename G>
+G graph::gnp(typename G::vertex_type n, double p, const GeneratorOptions& options){
+    using V = typename G::vertex_type;
+    if(p < 0 || p > 1){
+        throw std::invalid_argument("The probability must be in [0, 1].");
+    }
+    long rows = (long)n;
+    long rowsPerChunk = 1024;
+    long chunks = (rows + rowsPerChunk - 1) / rowsPerChunk;
+    DynamicArray<DynamicArray<EdgeOf<G>>> parts = makeParts<G>(chunks);
+    if(p > 0){
+        double logq = p < 1 ? std::log(1 - p) : 0;
+        forChunks(chunks, options.pool, [&](long c){
+            DynamicArray<EdgeOf<G>>& part = parts[c];
+            long last = (c + 1) * rowsPerChunk < rows ? (c + 1) * rowsPerChunk : rows;
+            for(long u = c * rowsPerChunk; u < last; u++){
+                Random random(options.seed, EDGE_STREAM, u);
+                // the candidates of row u: all the other vertices (directed) or the bigger ones (undirected)
+                long first = options.directed ? 0 : u + 1;
+                long candidates = options.directed ? rows - 1 : rows - u - 1;
+                long index = -1;
+                while(true){
+                    if(p < 1){
+                        index += 1 + (long)std::floor(std::log(1 - random.uniform()) / logq);
+                    }
+                    else{
+                        index++;
+                    }
+                    if(index >= candidates) break;
+                    long v = first + index;
+                    if(options.directed && v >= u) v++;     // skip the self loop
+                    part.push_back(EdgeOf<G>({(V)(u + 1), (V)(v + 1)}, randomWeight<G>(random, options)));
+                }
+            }
+        });
+    }
+    return buildGraph<G>(n, parts, options);
+}
+
+//////////////////////////////////////////
+// G(n, m)
+//////////////////////////////////////////
+/*
+Random pairs are drawn in numbered batches until there are m distinct ones,
+the first m distinct pairs of the random sequence are kept (a uniform choice of m edges)
+*/
+template <typename G>
+G graph::gnm(typename G::vertex_type n, long long m, const GeneratorOptions& options){
+    using V = typename G::vertex_type;
+    struct Drawn{
+        V src;
+        V dest;
+        long long order;    // position in the random sequence
+    };
+    long long pairs = (long long)n * ((long long)n - 1) / (options.directed ? 1 : 2);
+    if(m < 0 || m > pairs){
+        throw std::invalid_argument("Too many edges for the number of vertices.");
+    }
+    checkEdgeCount(m, options);
+
+    DynamicArray<Drawn> distinct;
+    long long drawn = 0;
+    long nextChunk = 0;
+    while(distinct.getSize() < m){
+        long long missing = m - distinct.getSize();
+        long long batch = missing + missing / 8 + 64;
+        long chunks = (long)((batch + CHUNK - 1) / CHUNK);
+        DynamicArray<DynamicArray<Drawn>> parts;
+        parts.reserve((int)chunks);
+        for(long c = 0; c < chunks; c++){
+            parts.emplace_back();
+        }
+        forChunks(chunks, options.pool, [&](long c){
+            Random random(options.seed, EDGE_STREAM, nextChunk + c);
+            DynamicArray<Drawn>& part = parts[c];
+            part.reserve(CHUNK);
+            for(long e = 0; e < CHUNK; e++){
+                V src = (V)(random.below(n) + 1);
+                V dest = (V)(random.below(n) + 1);
+                if(src == dest) continue;
+                if(!options.directed && dest < src) std::swap(src, dest);
+                part.push_back(Drawn{src, dest, drawn + c * CHUNK + e});
+            }
+        });
+        nextChunk += chunks;
+        drawn += (long long)chunks * CHUNK;
+        for(const DynamicArray<Drawn>& part : parts){
+            for(const Drawn& d : part){
+                distinct.push_back(d);
+            }
+        }
+
+        // keep the earliest copy of every pair
+        std::sort(distinct.begin(), distinct.end(), [](const Drawn& a, const Drawn& b){
+            if(a.src != b.src) return a.src < b.src;
+            if(a.dest != b.dest) return a.dest < b.dest;
+            return a.order < b.order;
+        });
+        int unique = 0;
+        for(int i = 0; i < distinct.getSize(); i++){
+            if(unique > 0 && distinct[unique - 1].src == distinct[i].src && distinct[unique - 1].dest == distinct[i].dest){
+                continue;
+            }
+            distinct[unique++] = distinct[i];
+        }
+        while(distinct.getSize() > unique){
+            distinct.removeAt(distinct.getSize() - 1);
+        }
+    }
+
+    std::sort(distinct.begin(), distinct.end(), [](const Drawn& a, const Drawn& b){
+        return a.order < b.order;
+    });
+    long chunks = (long)((m + CHUNK - 1) / CHUNK);
+    DynamicArray<DynamicArray<EdgeOf<G>>> edgeParts = makeParts<G>(chunks);
+    forChunks(chunks, options.pool, [&](long c){
+        Random random(options.seed, WEIGHT_STREAM, c);
+        long long last = (c + 1) * CHUNK < m ? (c + 1) * CHUNK : m;
+        for(long long i = c * CHUNK; i < last; i++){
+            const Drawn& d = distinct[(int)i];
+            edgeParts[c].push_back(EdgeOf<G>({d.src, d.dest}, randomWeight<G>(random, options)));
+        }
+    });
+    return buildGraph<G>(n, edgeParts, options);
+}
+
+//////////////////////////////////////////
+// Grid
+//////////////////////////////////////////
+template <typename G>
+G graph::grid(typename G::vertex_type rows, typename G::vertex_type cols, const GeneratorOptions& options){
+    using V = typename G::vertex_type;
+    if(rows < 1 || cols < 1 || (long long)rows * cols > (long long)std::numeric_limits<V>::max()){
+        throw std::invalid_argument("Invalid grid size.");
+    }
+    long rowsPerChunk = CHUNK / cols > 0 ? CHUNK / cols : 1;
+    long chunks = ((long)rows + rowsPerChunk - 1) / rowsPerChunk;
+    DynamicArray<DynamicArray<EdgeOf<G>>> parts = makeParts<G>(chunks);
+    forChunks(chunks, options.pool, [&](long c){
+        Random random(options.seed, EDGE_STREAM, c);
+        long last = (c + 1) * rowsPerChunk < (long)rows ? (c + 1) * rowsPerChunk : (long)rows;
+        for(long r = c * rowsPerChunk; r < last; r++){
+            for(long col = 0; col < (long)cols; col++){
+                V id = (V)(r * cols + col + 1);
+                if(col + 1 < (long)cols){
+                    parts[c].push_back(EdgeOf<G>({id, (V)(id + 1)}, randomWeight<G>(random, options)));
+                }
+                if(r + 1 < (long)rows){
+                    parts[c].push_back(EdgeOf<G>({id, (V)(id + cols)}, randomWeight<G>(random, options)));
+                }
+            }
+        }
+    });
+    return buildGraph<G>((V)(rows * cols), parts, options);
+}
+
+//////////////////////////////////////////
+// Random geometric
+//////////////////////////////////////////
+/*
+The points are bucketed into square cells with the side radius (a counting sort),
+so every point is compared only with the points of its cell and the 8 cells around it
+*/
+template <typename G>
+G graph::randomGeometric(typename G::vertex_type n, double radius, const GeneratorOptions& options){
+    using V = typename G::vertex_type;
+    if(radius <= 0){
+        throw std::invalid_argument("The radius must be positive.");
+    }
+    long count = (long)n;
+    DynamicArray<double> xs(count > 0 ? count : 1);
+    DynamicArray<double> ys(count > 0 ? count : 1);
+    for(long i = 0; i < count; i++){
+        xs.push_back(0);
+        ys.push_back(0);
+    }
+    long pointChunks = (count + CHUNK - 1) / CHUNK;
+    forChunks(pointChunks, options.pool, [&](long c){
+        Random random(options.seed, EDGE_STREAM, c);
+        long last = (c + 1) * CHUNK < count ? (c + 1) * CHUNK : count;
+        for(long i = c * CHUNK; i < last; i++){
+            xs[i] = random.uniform();
+            ys[i] = random.uniform();
+        }
+    });
+
+    // cells per side, at most about one cell per point
+    long side = (long)(1.0 / radius);
+    long maxSide = (long)std::sqrt((double)count) + 1;
+    if(side > maxSide) side = maxSide;
+    if(side < 1) side = 1;
+    double cellSize = 1.0 / side;
+    DynamicArray<int> cellOf(count > 0 ? count : 1);
+    DynamicArray<int> cellStart(side * side + 1);
+    DynamicArray<int> order(count > 0 ? count : 1);
+    for(long i = 0; i <= side * side; i++){
+        cellStart.push_back(0);
+    }
+    for(long i = 0; i < count; i++){
+        long cx = std::min(side - 1, (long)(xs[i] / cellSize));
+        long cy = std::min(side - 1, (long)(ys[i] / cellSize));
+        cellOf.push_back((int)(cy * side + cx));
+        cellStart[cellOf[i] + 1]++;
+        order.push_back(0);
+    }
+    for(long i = 0; i < side * side; i++){
+        cellStart[i + 1] += cellStart[i];
+    }
+    DynamicArray<int> fill(cellStart);
+    for(long i = 0; i < count; i++){
+        order[fill[cellOf[i]]++] = (int)i;
+    }
+
+    double radius2 = radius * radius;
+    DynamicArray<DynamicArray<EdgeOf<G>>> parts = makeParts<G>(pointChunks);
+    forChunks(pointChunks, options.pool, [&](long c){
+        long last = (c + 1) * CHUNK < count ? (c + 1) * CHUNK : count;
+        for(long u = c * CHUNK; u < last; u++){
+            long cx = cellOf[u] % side;
+            long cy = cellOf[u] / side;
+            for(long ny = std::max(0L, cy - 1); ny <= std::min(side - 1, cy + 1); ny++){
+                for(long nx = std::max(0L, cx - 1); nx <= std::min(side - 1, cx + 1); nx++){
+                    long cell = ny * side + nx;
+                    for(int k = cellStart[cell]; k < cellStart[cell + 1]; k++){
+                        long v = order[k];
+                        bool take = options.directed ? v != u : v > u;
+                        if(!take) continue;
+                        double dx = xs[u] - xs[v];
+                        double dy = ys[u] - ys[v];
+                        double distance2 = dx * dx + dy * dy;
+                        if(distance2 <= radius2){
+                            double fraction = std::sqrt(distance2) / radius;
+                            parts[c].push_back(EdgeOf<G>({(V)(u + 1), (V)(v + 1)}, weightAt<G>(fraction, options)));
+                        }
+                    }
+                }
+            }
+        }
+    });
+    return buildGraph<G>(n, parts, options);
+}
+
+#define INSTANTIATE_GENERATORS(G) \
+    template G graph::rmat<G>(int scale, int edgeFactor, const GeneratorOptions& options, const RmatParams& params); \
+    template G graph::gnp<G>(typename G::vertex_type n, double p, const GeneratorOptions& options); \
+    template G graph::gnm<G>(typename G::vertex_type n, long long m, const GeneratorOptions& options); \
+    template G graph::grid<G>(typename G::vertex_type rows, typename G::vertex_type cols, const GeneratorOptions& options); \
+    template G graph::randomGeometric<G>(typename G::vertex_type n, double radius, const GeneratorOptions& options);
+
+using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+using GraphF32 = BasicGraph<uint32_t, float>;
+using GraphI64 = BasicGraph<uint32_t, int64_t>;
+using UnweightedGraphU32 = BasicGraph<uint32_t, uint32_t, Unweighted>;
+
+INSTANTIATE_GENERATORS(Graph)
+INSTANTIATE_GENERATORS(GraphU8)
+INSTANTIATE_GENERATORS(GraphF32)
+INSTANTIATE_GENERATORS(GraphI64)
+INSTANTIATE_GENERATORS(UnweightedGraph)
+INSTANTIATE_GENERATORS(UnweightedGraphU32)
+
+#undef INSTANTIATE_GENERATORS
@@ -0,0 +1,63 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <cstdint>
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+namespace graph {
+
+    /*
+    Options shared by all the generators.
+    The output depends only on the parameters and the seed - the work is split into fixed chunks,
+    every chunk has its own random stream, so the same graph is made with or without a pool and with any number of threads.
+    For a compressed (CSR like) graph, build a CompressedGraph from the result.
+    */
+    struct GeneratorOptions{
+        uint64_t seed = 1;
+        double minWeight = 1;       // weights are uniform in [minWeight, maxWeight] (whole numbers for integral weight types)
+        double maxWeight = 100;
+        bool directed = false;      // false - every edge is added in both directions
+        ThreadPool* pool = nullptr; // null - everything runs on the calling thread
+    };
+
+    // R-MAT quadrant probabilities (d = 1 - a - b - c), the defaults are the Graph500 parameters
+    struct RmatParams{
+        double a = 0.57;
+        double b = 0.19;
+        double c = 0.19;
+        bool permute = true;        // shuffle the vertex ids, so the high degree vertices are not the small ids
+    };
+
+    /*
+    The generated edge lists have self loops removed and duplicates merged (a Graph can't hold them),
+    so R-MAT and G(n, p) return slightly fewer edges than requested / expected.
+    G is a BasicGraph, with an Unweighted graph all the weights are 1.
+    */
+
+    // 2^scale vertices and edgeFactor * 2^scale sampled edges (Graph500 uses edgeFactor 16)
+    template <typename G = Graph>
+    G rmat(int scale, int edgeFactor, const GeneratorOptions& options = GeneratorOptions(), const RmatParams& params = RmatParams());
+
+    // Erdos-Renyi G(n, p) - every pair is an edge with probability p (geometric skipping, O(n + m))
+    template <typename G = Graph>
+    G gnp(typename G::vertex_type n, double p, const GeneratorOptions& options = GeneratorOptions());
+
+    // Erdos-Renyi G(n, m) - exactly m distinct edges chosen uniformly
+    template <typename G = Graph>
+    G gnm(typename G::vertex_type n, long long m, const GeneratorOptions& options = GeneratorOptions());
+
+    // rows x cols grid with 4 neighbors, vertex (r, c) is r * cols + c + 1, random weights
+    template <typename G = Graph>
+    G grid(typename G::vertex_type rows, typename G::vertex_type cols, const GeneratorOptions& options = GeneratorOptions());
+
+    // n random points in the unit square, points closer than radius are connected (road like graphs),
+    // the weight grows linearly with the distance from minWeight (distance 0) to maxWeight (distance radius)
+    template <typename G = Graph>
+    G randomGeometric(typename G::vertex_type n, double radius, const GeneratorOptions& options = GeneratorOptions());
+
+}  // namespace graph
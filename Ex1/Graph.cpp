@@ -3,170 +3,438 @@ author: Meir Yust
 mail: meyu251@gmail.com
 */
 
+#include <algorithm>
 #include <iostream>
+#include <cstring>
 #include "Graph.hpp"
 #include "Data_Structures.hpp"
 
 using namespace graph;
 
-Graph::Graph(int n){
-    adjList = new DynamicArray<Pair<int, int>>[n];  // first = neighbore, second = weight
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P>::BasicGraph(V n){
+    adjList = new ArenaList<edge_type>[n];  // first = neighbore, second = weight (only the neighbore if unweighted)
     this->numOfVertices = n;
+    numOfEdges = 0;
+    negativeEdges = 0;
+    inDegrees = new int[n > 0 ? n : 1]();
+    minWeight = W(0);
+    maxWeight = W(0);
+    weightRangeStale = false;
 }
 
-// copy constructor
-Graph::Graph(const Graph& g){
-    this->numOfVertices = g.numOfVertices;
-    adjList = new DynamicArray<Pair<int, int>>[numOfVertices];
-    for(int i = 0; i < numOfVertices; i++){
-        for(int j = 0; j < g.adjList[i].getSize(); j++){
-            adjList[i].push_back(g.adjList[i].get(j));
+/*
+Copy all the lists of other back to back into one slab, a single memcpy per list.
+Every list still takes its power of two block (so it can grow in place), and the slab is never
+smaller than the first slab of an arena; a graph without edges allocates no slab at all
+*/
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::copyLists(const BasicGraph& other){
+    size_t total = 0;
+    for(V i = 0; i < numOfVertices; i++){
+        if(!other.adjList[i].isEmpty()){
+            total += SlabArena<edge_type>::blockSize(other.adjList[i].getSize());
         }
     }
+    if(total > 0){
+        arena.reserve(total);
+    }
+    for(V i = 0; i < numOfVertices; i++){
+        adjList[i].assign(other.adjList[i].begin(), other.adjList[i].getSize(), arena);
+    }
+}
+
+// the statistics of other, inDegrees must already be allocated for numOfVertices vertices
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::copyStats(const BasicGraph& other){
+    numOfEdges = other.numOfEdges;
+    negativeEdges = other.negativeEdges;
+    minWeight = other.minWeight;
+    maxWeight = other.maxWeight;
+    weightRangeStale = other.weightRangeStale;
+    if(numOfVertices > 0){
+        std::memcpy(inDegrees, other.inDegrees, sizeof(int) * numOfVertices);
+    }
+}
+
+// copy constructor
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P>::BasicGraph(const BasicGraph& g){
+    this->numOfVertices = g.numOfVertices;
+    adjList = new ArenaList<edge_type>[numOfVertices];
+    inDegrees = new int[numOfVertices > 0 ? numOfVertices : 1];
+    copyLists(g);
+    copyStats(g);
+}
+
+// move constructor - the moved from graph is left with 0 vertices
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P>::BasicGraph(BasicGraph&& g) noexcept : arena(std::move(g.arena)){
+    adjList = g.adjList;
+    numOfVertices = g.numOfVertices;
+    inDegrees = g.inDegrees;
+    numOfEdges = g.numOfEdges;
+    negativeEdges = g.negativeEdges;
+    minWeight = g.minWeight;
+    maxWeight = g.maxWeight;
+    weightRangeStale = g.weightRangeStale;
+    g.adjList = nullptr;
+    g.inDegrees = nullptr;
+    g.numOfVertices = 0;
+    g.numOfEdges = 0;
+    g.negativeEdges = 0;
 }
 
-Graph::~Graph(){
+// the arena frees all the lists at once
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P>::~BasicGraph(){
     delete[] adjList;
+    delete[] inDegrees;
 }
 
-Graph& Graph::operator=(const Graph& other){
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P>& BasicGraph<V, W, P>::operator=(const BasicGraph& other){
     if(this != &other){
         delete[] adjList;
+        delete[] inDegrees;
+        arena.clear();
         numOfVertices = other.numOfVertices;
-        adjList = new DynamicArray<Pair<int, int>>[numOfVertices];
-        for(int i = 0; i < numOfVertices; i++){
-            for(int j = 0; j < other.adjList[i].getSize(); j++){
-                adjList[i].push_back(other.adjList[i].get(j));
-            }
-        }
+        adjList = new ArenaList<edge_type>[numOfVertices];
+        inDegrees = new int[numOfVertices > 0 ? numOfVertices : 1];
+        copyLists(other);
+        copyStats(other);
     }
     return *this;
 }
 
-int Graph::getNumOfVertices(){
-    return numOfVertices;
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P>& BasicGraph<V, W, P>::operator=(BasicGraph&& other) noexcept{
+    if(this != &other){
+        delete[] adjList;
+        delete[] inDegrees;
+        arena = std::move(other.arena);
+        adjList = other.adjList;
+        numOfVertices = other.numOfVertices;
+        inDegrees = other.inDegrees;
+        numOfEdges = other.numOfEdges;
+        negativeEdges = other.negativeEdges;
+        minWeight = other.minWeight;
+        maxWeight = other.maxWeight;
+        weightRangeStale = other.weightRangeStale;
+        other.adjList = nullptr;
+        other.inDegrees = nullptr;
+        other.numOfVertices = 0;
+        other.numOfEdges = 0;
+        other.negativeEdges = 0;
+    }
+    return *this;
+}
+
+template <typename V, typename W, typename P>
+typename BasicGraph<V, W, P>::edge_type BasicGraph<V, W, P>::makeEdge(V dest, W weight){
+    if constexpr(std::is_same<P, Unweighted>::value){
+        if(weight != W(1)){
+            throw std::invalid_argument("Unweighted graph supports only weight 1.");
+        }
+        return dest;
+    }
+    else{
+        return edge_type(dest, weight);
+    }
 }
 
 /*
-Add an undirected edge between src and dest
--does not support an edge from a vertex to itself
--if the edge already exists, throw an exception
--if the edge exist only in one direction, add it in the other direction
--if the edge does not exist, add it in both directions
+Statistics bookkeeping, called for every entry that is added to or removed from a list
 */
-void Graph::addEdge(int src, int dest, int weight){
-    if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest){
-        throw std::invalid_argument("Invalid edge.");
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::edgeAdded(V dest, W weight){
+    if(numOfEdges == 0){
+        minWeight = weight;
+        maxWeight = weight;
+        weightRangeStale = false;
+    }
+    else if(!weightRangeStale){
+        if(weight < minWeight) minWeight = weight;
+        if(maxWeight < weight) maxWeight = weight;
     }
+    numOfEdges++;
+    if(weight < W(0)) negativeEdges++;
+    inDegrees[dest - 1]++;
+}
 
-    // check if any of the edges already exists
-    bool srcEdge = false;
-    bool destEdge = false;
-    for(int i = 0; i < adjList[src - 1].getSize(); i++){
-        if(adjList[src - 1].get(i).first == dest){
-            srcEdge = true;
-            break;
-        }
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::edgeRemoved(V dest, W weight){
+    numOfEdges--;
+    if(weight < W(0)) negativeEdges--;
+    inDegrees[dest - 1]--;
+    // the range can only shrink when an edge on its border goes away
+    if(weight == minWeight || weight == maxWeight){
+        weightRangeStale = true;
     }
-    for(int i = 0; i < adjList[dest - 1].getSize(); i++){
-        if(adjList[dest - 1].get(i).first == src){
-            destEdge = true;
-            break;
+}
+
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::recomputeWeightRange() const{
+    bool first = true;
+    for(V i = 0; i < numOfVertices; i++){
+        for(const edge_type& edge : adjList[i]){
+            W weight = edgeWeight<W>(edge);
+            if(first || weight < minWeight) minWeight = weight;
+            if(first || maxWeight < weight) maxWeight = weight;
+            first = false;
         }
     }
+    weightRangeStale = false;
+}
 
-    if(srcEdge && destEdge){
-        throw std::invalid_argument("Edge already exists.");
-    }
-    else if(srcEdge){
-        std::cout << "Edge from " << src << " to " << dest << " already exists." << std::endl;
-        adjList[dest - 1].push_back({src, weight});
+template <typename V, typename W, typename P>
+V BasicGraph<V, W, P>::getNumOfVertices() const{
+    return numOfVertices;
+}
+
+//////////////////////////////////////////
+// LoadReport
+//////////////////////////////////////////
+void LoadReport::count(EdgeStatus status){
+    switch(status){
+        case EdgeStatus::Added: added++; break;
+        case EdgeStatus::ForwardExisted:
+        case EdgeStatus::BackwardExisted: completed++; break;
+        case EdgeStatus::AlreadyExists: duplicates++; break;
+        case EdgeStatus::Invalid:
+        case EdgeStatus::InvalidWeight: invalid++; break;
     }
-    else if(destEdge){
-        std::cout << "Edge from " << dest << " to " << src << " already exists." << std::endl;
-        adjList[src - 1].push_back({dest, weight});
+}
+
+long long LoadReport::total() const{
+    return added + completed + duplicates + invalid;
+}
+
+template <typename V, typename W, typename P>
+bool BasicGraph<V, W, P>::validWeight(W weight){
+    if constexpr(std::is_same<P, Unweighted>::value){
+        return weight == W(1);
     }
     else{
-        adjList[src - 1].push_back({dest, weight});
-        adjList[dest - 1].push_back({src, weight});
+        (void)weight;
+        return true;
+    }
+}
+
+// src must be a valid vertex
+template <typename V, typename W, typename P>
+bool BasicGraph<V, W, P>::findEdge(V src, V dest) const{
+    for(const edge_type& edge : adjList[src - 1]){
+        if(edgeTarget(edge) == dest){
+            return true;
+        }
     }
+    return false;
 }
 
 /*
-Add an undirected edge between src and dest with weight 1
-- act as the function above
+Add an undirected edge between src and dest without printing or throwing
+-the edge is added only in the directions that don't exist yet
 */
-void Graph::addEdge(int src, int dest){
+template <typename V, typename W, typename P>
+EdgeStatus BasicGraph<V, W, P>::tryAddEdge(V src, V dest, W weight){
     if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest){
-        throw std::invalid_argument("Invalid edge.");
+        return EdgeStatus::Invalid;
     }
 
-    // Check if any of the edges already exists
-    bool srcEdge = false;
-    bool destEdge = false;
-    for(int i = 0; i < adjList[src - 1].getSize(); i++){
-        if(adjList[src - 1].get(i).first == dest){
-            srcEdge = true;
-            break;
-        }
+    bool srcEdge = findEdge(src, dest);
+    bool destEdge = findEdge(dest, src);
+    if(srcEdge && destEdge){
+        return EdgeStatus::AlreadyExists;
     }
-    for(int i = 0; i < adjList[dest - 1].getSize(); i++){
-        if(adjList[dest - 1].get(i).first == src){
-            destEdge = true;
-            break;
-        }
+    if(!validWeight(weight)){
+        return EdgeStatus::InvalidWeight;
     }
 
-    if(srcEdge && destEdge){
-        throw std::invalid_argument("Edge already exists.");
+    if(!srcEdge){
+        adjList[src - 1].push_back(makeEdge(dest, weight), arena);
+        edgeAdded(dest, weight);
     }
-    else if(srcEdge){
-        std::cout << "Edge from " << src << " to " << dest << " already exists." << std::endl;
-        adjList[dest - 1].push_back({src, 1});
+    if(!destEdge){
+        adjList[dest - 1].push_back(makeEdge(src, weight), arena);
+        edgeAdded(src, weight);
     }
-    else if(destEdge){
-        std::cout << "Edge from " << dest << " to " << src << " already exists." << std::endl;
-        adjList[src - 1].push_back({dest, 1});
+    return srcEdge ? EdgeStatus::ForwardExisted : destEdge ? EdgeStatus::BackwardExisted : EdgeStatus::Added;
+}
+
+template <typename V, typename W, typename P>
+EdgeStatus BasicGraph<V, W, P>::tryAddDirectedEdge(V src, V dest, W weight){
+    if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest){
+        return EdgeStatus::Invalid;
     }
-    else{
-        adjList[src - 1].push_back({dest, 1});
-        adjList[dest - 1].push_back({src, 1});
+    if(findEdge(src, dest)){
+        return EdgeStatus::AlreadyExists;
     }
+    if(!validWeight(weight)){
+        return EdgeStatus::InvalidWeight;
+    }
+    adjList[src - 1].push_back(makeEdge(dest, weight), arena);
+    edgeAdded(dest, weight);
+    return EdgeStatus::Added;
 }
 
-void Graph::addDirectedEdge(int src, int dest, int weight){
-    if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest){
-        throw std::invalid_argument("Invalid edge.");
+/*
+Bulk insertion, nothing is printed or thrown - every edge is counted in the report by its status
+*/
+template <typename V, typename W, typename P>
+LoadReport BasicGraph<V, W, P>::loadEdges(const DynamicArray<Pair<Pair<V, V>, W>>& edges, bool directed){
+    LoadReport report;
+    for(const Pair<Pair<V, V>, W>& edge : edges){
+        if(directed){
+            report.count(tryAddDirectedEdge(edge.first.first, edge.first.second, edge.second));
+        }
+        else{
+            report.count(tryAddEdge(edge.first.first, edge.first.second, edge.second));
+        }
     }
+    return report;
+}
 
-    // check if the edge already exists
-    for(int i = 0; i < adjList[src - 1].getSize(); i++){
-        if(adjList[src - 1].get(i).first == dest){
-            throw std::invalid_argument("Edge already exists.");
+/*
+Bulk insertion without the duplicate scan
+- the first pass counts the valid edges of every source, the second pass appends them
+  to lists that were already grown to their final size (one allocation per list)
+*/
+template <typename V, typename W, typename P>
+LoadReport BasicGraph<V, W, P>::appendUniqueEdges(const DynamicArray<Pair<Pair<V, V>, W>>& edges){
+    LoadReport report;
+    DynamicArray<int> counts(numOfVertices > 0 ? numOfVertices : 1);
+    for(V i = 0; i < numOfVertices; i++){
+        counts.push_back(0);
+    }
+    for(const Pair<Pair<V, V>, W>& edge : edges){
+        V src = edge.first.first;
+        V dest = edge.first.second;
+        if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest){
+            report.count(EdgeStatus::Invalid);
+        }
+        else if(!validWeight(edge.second)){
+            report.count(EdgeStatus::InvalidWeight);
+        }
+        else{
+            counts[src - 1]++;
         }
     }
 
-    adjList[src - 1].push_back({dest, weight});
+    size_t total = 0;
+    for(V i = 0; i < numOfVertices; i++){
+        if(counts[i] > 0){
+            total += SlabArena<edge_type>::blockSize(adjList[i].getSize() + counts[i]);
+        }
+    }
+    arena.reserve(total);
+    for(V i = 0; i < numOfVertices; i++){
+        if(counts[i] > 0){
+            adjList[i].reserve(adjList[i].getSize() + counts[i], arena);
+        }
+    }
+
+    for(const Pair<Pair<V, V>, W>& edge : edges){
+        V src = edge.first.first;
+        V dest = edge.first.second;
+        if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest || !validWeight(edge.second)){
+            continue;
+        }
+        adjList[src - 1].push_back(makeEdge(dest, edge.second), arena);
+        edgeAdded(dest, edge.second);
+        report.count(EdgeStatus::Added);
+    }
+    return report;
 }
 
-void Graph::addDirectedEdge(int src, int dest){
-    if(src < 1 || src > numOfVertices || dest < 1 || dest > numOfVertices || src == dest){
-        throw std::invalid_argument("Invalid edge.");
+template <typename V, typename W, typename P>
+LoadReport BasicGraph<V, W, P>::appendUniqueEdges(V src, ArrayView<edge_type> entries){
+    LoadReport report;
+    if(src < 1 || src > numOfVertices){
+        for(int i = 0; i < entries.getSize(); i++){
+            report.count(EdgeStatus::Invalid);
+        }
+        return report;
+    }
+    ArenaList<edge_type>& list = adjList[src - 1];
+    list.reserve(list.getSize() + entries.getSize(), arena);
+    for(const edge_type& entry : entries){
+        V dest = edgeTarget(entry);
+        W weight = edgeWeight<W>(entry);
+        if(dest < 1 || dest > numOfVertices || dest == src){
+            report.count(EdgeStatus::Invalid);
+        }
+        else if(!validWeight(weight)){
+            report.count(EdgeStatus::InvalidWeight);
+        }
+        else{
+            list.push_back(entry, arena);
+            edgeAdded(dest, weight);
+            report.count(EdgeStatus::Added);
+        }
     }
+    return report;
+}
 
-    // check if the edge already exists
-    for(int i = 0; i < adjList[src - 1].getSize(); i++){
-        if(adjList[src - 1].get(i).first == dest){
+/*
+Add an undirected edge between src and dest
+-does not support an edge from a vertex to itself
+-if the edge already exists, throw an exception
+-if the edge exist only in one direction, add it in the other direction
+-if the edge does not exist, add it in both directions
+*/
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::addEdge(V src, V dest, W weight){
+    switch(tryAddEdge(src, dest, weight)){
+        case EdgeStatus::Invalid:
+            throw std::invalid_argument("Invalid edge.");
+        case EdgeStatus::AlreadyExists:
             throw std::invalid_argument("Edge already exists.");
-        }
+        case EdgeStatus::InvalidWeight:
+            throw std::invalid_argument("Unweighted graph supports only weight 1.");
+        case EdgeStatus::ForwardExisted:
+            std::cout << "Edge from " << src << " to " << dest << " already exists." << std::endl;
+            break;
+        case EdgeStatus::BackwardExisted:
+            std::cout << "Edge from " << dest << " to " << src << " already exists." << std::endl;
+            break;
+        case EdgeStatus::Added:
+            break;
     }
+}
 
-    adjList[src - 1].push_back({dest, 1});
+/*
+Add an undirected edge between src and dest with weight 1
+- act as the function above
+*/
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::addEdge(V src, V dest){
+    addEdge(src, dest, W(1));
 }
 
-bool Graph::hasEdge(int src, int dest){
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::addDirectedEdge(V src, V dest, W weight){
+    switch(tryAddDirectedEdge(src, dest, weight)){
+        case EdgeStatus::Invalid:
+            throw std::invalid_argument("Invalid edge.");
+        case EdgeStatus::AlreadyExists:
+            throw std::invalid_argument("Edge already exists.");
+        case EdgeStatus::InvalidWeight:
+            throw std::invalid_argument("Unweighted graph supports only weight 1.");
+        default:
+            break;
+    }
+}
+
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::addDirectedEdge(V src, V dest){
+    addDirectedEdge(src, dest, W(1));
+}
+
+template <typename V, typename W, typename P>
+bool BasicGraph<V, W, P>::hasEdge(V src, V dest){
     for(int i = 0; i < adjList[src - 1].getSize(); i++){
-        if(adjList[src - 1].get(i).first == dest){
+        if(edgeTarget(adjList[src - 1].get(i)) == dest){
             return true;
         }
     }
@@ -175,27 +443,72 @@ bool Graph::hasEdge(int src, int dest){
 
 /*
 Remove a directed edge between src and dest
+- a single scan, the last edge of the list takes the place of the removed one,
+  so the order of the neighbors is not kept
 */
-void Graph::removeEdge(int src, int dest){
-    if(!hasEdge(src, dest)){
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::removeEdge(V src, V dest){
+    if(src < 1 || src > numOfVertices){
         throw std::invalid_argument("Edge does not exist.");
     }
 
     for(int i = 0; i < adjList[src - 1].getSize(); i++){
-        if(adjList[src - 1].get(i).first == dest){
-            adjList[src - 1].removeAt(i);
-            break;
+        if(edgeTarget(adjList[src - 1].get(i)) == dest){
+            edgeRemoved(dest, edgeWeight<W>(adjList[src - 1].get(i)));
+            adjList[src - 1].removeAtUnordered(i);
+            return;
+        }
+    }
+    throw std::invalid_argument("Edge does not exist.");
+}
+
+/*
+Remove a batch of directed edges (src, dest)
+- every removed edge is marked with the target 0 (a tombstone, the vertices are numbered from 1)
+- then every list that was touched is compacted once, keeping the order of the remaining neighbors
+  (the touched sources are kept in a list of the batch size and sorted, no O(V) array per batch)
+- edges that don't exist (or appear twice in the batch) are skipped
+*/
+template <typename V, typename W, typename P>
+int BasicGraph<V, W, P>::removeEdges(const DynamicArray<Pair<V, V>>& batch){
+    for(const Pair<V, V>& edge : batch){
+        if(edge.first < 1 || edge.first > numOfVertices || edge.second < 1 || edge.second > numOfVertices){
+            throw std::invalid_argument("Invalid edge.");
         }
     }
-    
-    // remove the edge from dest to src
+    if(batch.isEmpty()){
+        return 0;
+    }
 
-    // for(int i = 0; i < adjList[dest - 1].getSize(); i++){
-    //     if(adjList[dest - 1].get(i).first == src){
-    //         adjList[dest - 1].removeAt(i);
-    //         break;
-    //     }
-    // }
+    DynamicArray<V> touched(batch.getSize());
+    int removed = 0;
+    for(const Pair<V, V>& edge : batch){
+        ArenaList<edge_type>& list = adjList[edge.first - 1];
+        for(edge_type& entry : list){
+            if(edgeTarget(entry) == edge.second){
+                edgeRemoved(edge.second, edgeWeight<W>(entry));
+                setEdgeTarget(entry, V(0));
+                touched.push_back(edge.first);
+                removed++;
+                break;
+            }
+        }
+    }
+
+    std::sort(touched.begin(), touched.end());
+    for(int t = 0; t < touched.getSize(); t++){
+        if(t > 0 && touched[t] == touched[t - 1]) continue;
+        V i = touched[t] - 1;
+        edge_type* entries = adjList[i].begin();
+        int write = 0;
+        for(int read = 0; read < adjList[i].getSize(); read++){
+            if(edgeTarget(entries[read]) != 0){
+                entries[write++] = entries[read];
+            }
+        }
+        adjList[i].truncate(write);
+    }
+    return removed;
 }
 
 /*
@@ -209,19 +522,21 @@ Print the graph in the following format:
 
 if there are no edeges for a vertex, print "Vertex i has no neighbors."
 */
-void Graph::printGraph(){
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::printGraph(){
     if(numOfVertices == 0){
         throw std::invalid_argument("Graph is empty.");
     }
 
-    for(int i = 0; i < numOfVertices; i++){
+    for(V i = 0; i < numOfVertices; i++){
         if(adjList[i].isEmpty()){
             std::cout << "Vertex " << i+1 << " has no neighbors." << std::endl;
             continue;
         }
 
         for(int j = 0; j < adjList[i].getSize(); j++){
-            std::cout << "{" << i+1 << "->" << adjList[i].get(j).first << " (" << adjList[i].get(j).second << ")}";
+            // the unary + prints 8 bit weights as numbers and not as characters
+            std::cout << "{" << i+1 << "->" << edgeTarget(adjList[i].get(j)) << " (" << +edgeWeight<W>(adjList[i].get(j)) << ")}";
             if(j != adjList[i].getSize() - 1){
                 std::cout << ", ";
             }
@@ -232,18 +547,100 @@ void Graph::printGraph(){
     }
 }
 
-DynamicArray<Pair<int, int>> Graph::getNeighbors(int vertex){
-    return adjList[vertex - 1];
+template <typename V, typename W, typename P>
+DynamicArray<Pair<V, W>> BasicGraph<V, W, P>::getNeighbors(V vertex){
+    DynamicArray<Pair<V, W>> ans;
+    for(const edge_type& edge : adjList[vertex - 1]){
+        ans.push_back(Pair<V, W>(edgeTarget(edge), edgeWeight<W>(edge)));
+    }
+    return ans;
+}
+
+/*
+Return the adjacency list of a vertex without copying it.
+Used by the algorithms to iterate over the neighbors of a vertex.
+*/
+template <typename V, typename W, typename P>
+ArrayView<typename BasicGraph<V, W, P>::edge_type> BasicGraph<V, W, P>::neighbors(V vertex) const{
+    if(vertex < 1 || vertex > numOfVertices){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    return adjList[vertex - 1].view();
 }
 
-bool Graph::hasNegativeEdge(){
-    for(int i = 0; i < numOfVertices; i++){
-        DynamicArray<Pair<int, int>> neighbors = getNeighbors(i + 1);
-        for(int j = 0; j < neighbors.getSize(); j++){
-            if(neighbors[j].second < 0){
-                return true;
-            }
-        }
+template <typename V, typename W, typename P>
+bool BasicGraph<V, W, P>::hasNegativeEdge() const{
+    if constexpr(!std::is_signed<W>::value || std::is_same<P, Unweighted>::value){
+        return false;   // unsigned weights can't be negative, unweighted edges are all 1
     }
-    return false;
-}
\ No newline at end of file
+    else{
+        return negativeEdges > 0;
+    }
+}
+
+template <typename V, typename W, typename P>
+long long BasicGraph<V, W, P>::getNumOfEdges() const{
+    return numOfEdges;
+}
+
+template <typename V, typename W, typename P>
+int BasicGraph<V, W, P>::degree(V vertex) const{
+    if(vertex < 1 || vertex > numOfVertices){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    return adjList[vertex - 1].getSize();
+}
+
+template <typename V, typename W, typename P>
+int BasicGraph<V, W, P>::inDegree(V vertex) const{
+    if(vertex < 1 || vertex > numOfVertices){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    return inDegrees[vertex - 1];
+}
+
+template <typename V, typename W, typename P>
+W BasicGraph<V, W, P>::getMinWeight() const{
+    if(numOfEdges == 0){
+        throw std::invalid_argument("Graph has no edges.");
+    }
+    if(weightRangeStale){
+        recomputeWeightRange();
+    }
+    return minWeight;
+}
+
+template <typename V, typename W, typename P>
+W BasicGraph<V, W, P>::getMaxWeight() const{
+    if(numOfEdges == 0){
+        throw std::invalid_argument("Graph has no edges.");
+    }
+    if(weightRangeStale){
+        recomputeWeightRange();
+    }
+    return maxWeight;
+}
+
+template <typename V, typename W, typename P>
+MemoryUsage BasicGraph<V, W, P>::memoryUsage() const{
+    size_t perVertex = (sizeof(ArenaList<edge_type>) + sizeof(int)) * (size_t)numOfVertices;
+    MemoryUsage usage;
+    usage.used = perVertex + sizeof(edge_type) * (size_t)numOfEdges;
+    usage.reserved = perVertex + arena.getReservedBytes();
+    return usage;
+}
+
+// a copy packs the lists (see copyLists), the old arena is freed when the copy is moved in
+template <typename V, typename W, typename P>
+void BasicGraph<V, W, P>::shrinkToFit(){
+    BasicGraph packed(*this);
+    *this = std::move(packed);
+}
+
+// The supported (vertex id, weight) combinations
+template class graph::BasicGraph<int, int>;
+template class graph::BasicGraph<uint32_t, uint8_t>;
+template class graph::BasicGraph<uint32_t, float>;
+template class graph::BasicGraph<uint32_t, int64_t>;
+template class graph::BasicGraph<int, int, graph::Unweighted>;
+template class graph::BasicGraph<uint32_t, uint32_t, graph::Unweighted>;
@@ -6,35 +6,178 @@ mail: meyu251@gmail.com
 #pragma once
 
 #include <iostream>
+#include <cstdint>
+#include <type_traits>
 #include "Data_Structures.hpp"
 
 namespace graph {
 
-    class Graph{
+    /*
+    Weight policies - decide what is stored for every edge in the adjacency lists
+    Weighted   - (neighbor, weight) pairs
+    Unweighted - only the neighbor, every edge has weight 1
+    */
+    struct Weighted{
+        template <typename V, typename W>
+        using Entry = Pair<V, W>;
+    };
+
+    struct Unweighted{
+        template <typename V, typename W>
+        using Entry = V;
+    };
+
+    // Access to an adjacency list entry of any policy
+    template <typename V, typename W>
+    inline V edgeTarget(const Pair<V, W>& edge){
+        return edge.first;
+    }
+
+    template <typename V>
+    inline V edgeTarget(const V& edge){
+        return edge;
+    }
+
+    template <typename W, typename V>
+    inline W edgeWeight(const Pair<V, W>& edge){
+        return edge.second;
+    }
+
+    template <typename W, typename V>
+    inline W edgeWeight(const V&){
+        return W(1);
+    }
+
+    template <typename V, typename W>
+    inline void setEdgeTarget(Pair<V, W>& edge, V target){
+        edge.first = target;
+    }
+
+    template <typename V>
+    inline void setEdgeTarget(V& edge, V target){
+        edge = target;
+    }
+
+    /*
+    The result of a silent insertion (tryAddEdge / tryAddDirectedEdge), nothing is printed or thrown
+    */
+    enum class EdgeStatus{
+        Added,              // the edge was added (both directions for an undirected edge)
+        ForwardExisted,     // undirected - src->dest already existed, only dest->src was added
+        BackwardExisted,    // undirected - dest->src already existed, only src->dest was added
+        AlreadyExists,      // nothing was added
+        Invalid,            // a vertex out of range or src == dest, nothing was added
+        InvalidWeight       // a weight other than 1 in an unweighted graph, nothing was added
+    };
+
+    // Counters of a bulk load, one per EdgeStatus
+    struct LoadReport{
+        long long added = 0;
+        long long completed = 0;        // ForwardExisted + BackwardExisted
+        long long duplicates = 0;
+        long long invalid = 0;          // Invalid + InvalidWeight
+
+        void count(EdgeStatus status);
+        long long total() const;
+    };
+
+    /*
+    V - the type of the vertex ids (vertices are numbered from 1 to n)
+    W - the type of the edge weights
+    P - the weight policy (Weighted or Unweighted)
+    The supported combinations are instantiated at the end of Graph.cpp
+    */
+    template <typename V, typename W, typename P = Weighted>
+    class BasicGraph{
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using policy_type = P;
+        using edge_type = typename P::template Entry<V, W>;    // (neighbor, weight) or just neighbor
+
     private:
         // becouse the vertex numbered from 1 to n
         // the list at index i represents the adjacency list of vertex (i+1)
-        DynamicArray<Pair<int, int>>* adjList;  // list of pairs (neighbor, weight)
-        int numOfVertices;
+        // the lists are allocated from one arena, so building, copying and destroying
+        // a graph takes a few large allocations instead of one (or more) per vertex
+        ArenaList<edge_type>* adjList;  // list of pairs (neighbor, weight) or of neighbors
+        SlabArena<edge_type> arena;
+        V numOfVertices;
+
+        // statistics kept up to date by every add and remove, so the queries below don't scan the lists
+        long long numOfEdges;       // directed entries, an undirected edge counts twice
+        long long negativeEdges;    // entries with a negative weight
+        int* inDegrees;             // inDegrees[i] = number of entries that point to vertex (i+1)
+        mutable W minWeight;
+        mutable W maxWeight;
+        mutable bool weightRangeStale;  // an edge with the min or max weight was removed, recompute on the next query
+
+        static edge_type makeEdge(V dest, W weight);
+        static bool validWeight(W weight);
+        bool findEdge(V src, V dest) const;
+        void copyLists(const BasicGraph& other);
+        void copyStats(const BasicGraph& other);
+        void edgeAdded(V dest, W weight);
+        void edgeRemoved(V dest, W weight);
+        void recomputeWeightRange() const;
 
     public:
-        
-        Graph(int n);
-        Graph(const Graph& g);    // copy constructor
-        ~Graph();
-        Graph& operator=(const Graph& other);
-
-        int getNumOfVertices();
-        void addEdge(int src, int dest, int weight);
-        void addEdge(int src, int dest);
-        void addDirectedEdge(int src, int dest, int weight);
-        void addDirectedEdge(int src, int dest);
-        bool hasEdge(int src, int dest);
-        void removeEdge(int src, int dest);
+
+        BasicGraph(V n);
+        BasicGraph(const BasicGraph& g);    // copy constructor
+        BasicGraph(BasicGraph&& g) noexcept;    // move constructor, takes the lists without copying them
+        ~BasicGraph();
+        BasicGraph& operator=(const BasicGraph& other);
+        BasicGraph& operator=(BasicGraph&& other) noexcept;
+
+        V getNumOfVertices() const;
+        void addEdge(V src, V dest, W weight);
+        void addEdge(V src, V dest);
+        void addDirectedEdge(V src, V dest, W weight);
+        void addDirectedEdge(V src, V dest);
+        // the same as addEdge / addDirectedEdge, but the result is returned instead of printed or thrown
+        EdgeStatus tryAddEdge(V src, V dest, W weight = W(1));
+        EdgeStatus tryAddDirectedEdge(V src, V dest, W weight = W(1));
+        // silent insertion of ((src, dest), weight) edges, undirected unless directed is true
+        LoadReport loadEdges(const DynamicArray<Pair<Pair<V, V>, W>>& edges, bool directed = false);
+        // directed edges that are known to be unique and not in the graph (e.g. generated and deduplicated):
+        // no duplicate scan, every list grows once to its final size. Invalid edges are counted and skipped
+        LoadReport appendUniqueEdges(const DynamicArray<Pair<Pair<V, V>, W>>& edges);
+        // the same for the out edges of one vertex given as stored entries (e.g. the lists of another graph type)
+        LoadReport appendUniqueEdges(V src, ArrayView<edge_type> entries);
+        bool hasEdge(V src, V dest);
+        void removeEdge(V src, V dest);
+        int removeEdges(const DynamicArray<Pair<V, V>>& batch);    // returns the number of edges removed
         void printGraph();
-        DynamicArray<Pair<int, int>> getNeighbors(int vertex);
-        bool hasNegativeEdge();
-    
-    };  // class Graph
+        DynamicArray<Pair<V, W>> getNeighbors(V vertex);
+        ArrayView<edge_type> neighbors(V vertex) const;    // read-only view, no copy
+        bool hasNegativeEdge() const;   // O(1)
+
+        long long getNumOfEdges() const;    // O(1), directed entries (an undirected edge counts twice)
+        int degree(V vertex) const;         // out degree, O(1)
+        int inDegree(V vertex) const;       // O(1)
+        W getMinWeight() const;             // O(1), unless an edge with the min / max weight was removed since the last query
+        W getMaxWeight() const;
+
+        // the lists array, the arena slabs and the in degrees; used counts only the entries in the lists,
+        // the slack is the growth room of the lists, the arena holes of removed / moved lists and the unused slab tail
+        MemoryUsage memoryUsage() const;
+        void shrinkToFit();     // repack all the lists back to back into one slab, each in its power of two block
+
+    };  // class BasicGraph
+
+    // The original int ids / int weights graph
+    using Graph = BasicGraph<int, int>;
+    // Only neighbor ids are stored, all the weights are 1
+    using UnweightedGraph = BasicGraph<int, int, Unweighted>;
+
+    /*
+    The type used to sum weights along a path:
+    64 bit integers for integral weights (no overflow on long paths), double for floating point weights
+    */
+    template <typename W>
+    struct DistanceOf{
+        using type = typename std::conditional<std::is_floating_point<W>::value, double, long long>::type;
+    };
 
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
@@ -0,0 +1,392 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include "GraphIO.hpp"
+
+using namespace graph;
+
+static const std::size_t BUFFER_SIZE = 1 << 20;    // 1 MiB between writes to the stream
+static const std::size_t NUMBER_ROOM = 32;         // enough for any integer or the shortest form of a double
+
+//////////////////////////////////////////
+// OutBuffer
+//////////////////////////////////////////
+/*
+A byte buffer that is either attached to a stream (written out whenever it is full)
+or kept in memory and grown (a chunk formatted by a worker, written later in order)
+*/
+class OutBuffer {
+private:
+    char* data;
+    std::size_t used;
+    std::size_t capacity;
+    std::ostream* out;
+
+public:
+    OutBuffer(std::size_t capacity = BUFFER_SIZE, std::ostream* out = nullptr){
+        this->data = new char[capacity];
+        this->used = 0;
+        this->capacity = capacity;
+        this->out = out;
+    }
+
+    OutBuffer(const OutBuffer& other) = delete;
+    OutBuffer& operator=(const OutBuffer& other) = delete;
+
+    ~OutBuffer(){
+        delete[] data;
+    }
+
+    // pointer to at least n free bytes
+    char* room(std::size_t n){
+        if(used + n > capacity){
+            if(out != nullptr && n <= capacity){
+                flush();
+            }
+            else{
+                std::size_t newCapacity = capacity * 2 > used + n ? capacity * 2 : used + n;
+                char* bigger = new char[newCapacity];
+                std::memcpy(bigger, data, used);
+                delete[] data;
+                data = bigger;
+                capacity = newCapacity;
+            }
+        }
+        return data + used;
+    }
+
+    void commit(char* end){
+        used = end - data;
+    }
+
+    void append(const char* text, std::size_t n){
+        std::memcpy(room(n), text, n);
+        used += n;
+    }
+
+    void append(char c){
+        *room(1) = c;
+        used++;
+    }
+
+    template <typename T>
+    void number(T value){
+        char* start = room(NUMBER_ROOM);
+        std::to_chars_result result = std::to_chars(start, start + NUMBER_ROOM, value);
+        commit(result.ptr);
+    }
+
+    template <typename T>
+    void raw(const T& value){
+        std::memcpy(room(sizeof(T)), &value, sizeof(T));
+        used += sizeof(T);
+    }
+
+    void writeTo(std::ostream& stream){
+        stream.write(data, used);
+        used = 0;
+    }
+
+    void flush(){
+        writeTo(*out);
+    }
+};
+
+/*
+Call format(buffer, v) for every vertex in order.
+Without a pool the buffer writes straight to out, with a pool a wave of chunks is formatted in parallel and then written in order
+*/
+template <typename G, typename Format>
+static void writeChunked(const G& g, std::ostream& out, ThreadPool* pool, Format format){
+    using V = typename G::vertex_type;
+    long n = (long)g.getNumOfVertices();
+    if(pool == nullptr || pool->getNumThreads() == 1 || n < 2){
+        OutBuffer buffer(BUFFER_SIZE, &out);
+        for(long v = 1; v <= n; v++){
+            format(buffer, (V)v);
+        }
+        buffer.flush();
+        return;
+    }
+
+    long waveChunks = (long)pool->getNumThreads() * 4;
+    long chunkVertices = n / waveChunks;
+    if(chunkVertices < 1) chunkVertices = 1;
+    if(chunkVertices > 65536) chunkVertices = 65536;     // bounds the memory of a wave
+    OutBuffer* chunks = new OutBuffer[waveChunks];
+    for(long first = 0; first < n; first += waveChunks * chunkVertices){
+        pool->parallel_for(0, waveChunks, [&](long c){
+            long begin = first + c * chunkVertices;
+            long end = begin + chunkVertices < n ? begin + chunkVertices : n;
+            for(long v = begin; v < end; v++){
+                format(chunks[c], (V)(v + 1));
+            }
+        }, 1);
+        for(long c = 0; c < waveChunks; c++){
+            chunks[c].writeTo(out);
+        }
+    }
+    delete[] chunks;
+}
+
+static void checkStream(const std::ostream& out){
+    if(!out){
+        throw std::invalid_argument("Writing the graph failed.");
+    }
+}
+
+static std::ofstream openOutput(const std::string& path){
+    std::ofstream file(path, std::ios::binary);
+    if(!file){
+        throw std::invalid_argument("Cannot open the file " + path + ".");
+    }
+    return file;
+}
+
+//////////////////////////////////////////
+// Edge list
+//////////////////////////////////////////
+template <typename G>
+void graph::writeEdgeList(const G& g, std::ostream& out, ThreadPool* pool){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    writeChunked(g, out, pool, [&g](OutBuffer& buffer, V v){
+        for(const auto& edge : g.neighbors(v)){
+            buffer.number(v);
+            buffer.append(' ');
+            buffer.number(edgeTarget(edge));
+            buffer.append(' ');
+            buffer.number(edgeWeight<W>(edge));
+            buffer.append('\n');
+        }
+    });
+    checkStream(out);
+}
+
+template <typename G>
+void graph::writeEdgeList(const G& g, const std::string& path, ThreadPool* pool){
+    std::ofstream file = openOutput(path);
+    writeEdgeList(g, file, pool);
+}
+
+//////////////////////////////////////////
+// DOT
+//////////////////////////////////////////
+template <typename G>
+void graph::writeDot(const G& g, std::ostream& out, bool directed, ThreadPool* pool){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    const char* header = directed ? "digraph G {\n" : "graph G {\n";
+    const char* arrow = directed ? " -> " : " -- ";
+    out.write(header, std::strlen(header));
+    writeChunked(g, out, pool, [&g, directed, arrow](OutBuffer& buffer, V v){
+        if(g.neighbors(v).getSize() == 0){
+            buffer.append("  ", 2);
+            buffer.number(v);
+            buffer.append(";\n", 2);
+            return;
+        }
+        for(const auto& edge : g.neighbors(v)){
+            V target = edgeTarget(edge);
+            if(!directed && target < v) continue;   // written from the other end
+            buffer.append("  ", 2);
+            buffer.number(v);
+            buffer.append(arrow, 4);
+            buffer.number(target);
+            buffer.append(" [label=", 8);
+            buffer.number(edgeWeight<W>(edge));
+            buffer.append("];\n", 3);
+        }
+    });
+    out.write("}\n", 2);
+    checkStream(out);
+}
+
+template <typename G>
+void graph::writeDot(const G& g, const std::string& path, bool directed, ThreadPool* pool){
+    std::ofstream file = openOutput(path);
+    writeDot(g, file, directed, pool);
+}
+
+//////////////////////////////////////////
+// Binary
+//////////////////////////////////////////
+template <typename G>
+void graph::writeBinary(const G& g, std::ostream& out){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    BinaryHeader header;
+    std::memcpy(header.magic, "SP2E", 4);
+    header.version = 1;
+    header.vertexSize = sizeof(V);
+    header.weightSize = sizeof(W);
+    header.numOfVertices = g.getNumOfVertices();
+    header.numOfEdges = 0;
+    for(V v = 1; v <= g.getNumOfVertices(); v++){
+        header.numOfEdges += g.neighbors(v).getSize();
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    writeChunked(g, out, nullptr, [&g](OutBuffer& buffer, V v){
+        for(const auto& edge : g.neighbors(v)){
+            buffer.raw(v);
+            buffer.raw(edgeTarget(edge));
+            buffer.raw(edgeWeight<W>(edge));
+        }
+    });
+    checkStream(out);
+}
+
+template <typename G>
+void graph::writeBinary(const G& g, const std::string& path){
+    std::ofstream file = openOutput(path);
+    writeBinary(g, file);
+}
+
+template <typename G>
+BinaryHeader graph::readBinaryHeader(std::istream& in){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    BinaryHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in || std::memcmp(header.magic, "SP2E", 4) != 0){
+        throw std::invalid_argument("Not a graph binary file.");
+    }
+    if(header.version != 1){
+        throw std::invalid_argument("Unsupported graph binary file version.");
+    }
+    if(header.vertexSize != sizeof(V) || header.weightSize != sizeof(W)){
+        throw std::invalid_argument("The file was written with other vertex or weight types.");
+    }
+    if(header.numOfVertices > (uint64_t)std::numeric_limits<V>::max()){
+        throw std::invalid_argument("Too many vertices for the vertex type.");
+    }
+    return header;
+}
+
+/*
+The records are read in blocks of about BUFFER_SIZE bytes and loaded at once with appendUniqueEdges
+(every list is allocated once, no duplicate scan per edge); the duplicates are found afterwards by one sort of every list
+*/
+template <typename G>
+G graph::readBinary(std::istream& in){
+    using V = typename G::vertex_type;
+    using W = typename G::weight_type;
+    using Record = Pair<Pair<V, V>, W>;
+    BinaryHeader header = readBinaryHeader<G>(in);
+    if(header.numOfEdges > (uint64_t)std::numeric_limits<int>::max()){
+        throw std::invalid_argument("Too many edges in the graph binary file.");
+    }
+
+    const std::size_t recordSize = 2 * sizeof(V) + sizeof(W);
+    const std::size_t blockRecords = BUFFER_SIZE / recordSize;
+    // grown with the records that were really read, a corrupted count doesn't allocate up front
+    DynamicArray<Record> records(header.numOfEdges < blockRecords ? (int)header.numOfEdges + 1 : (int)blockRecords);
+    char* block = new char[blockRecords * recordSize];
+    uint64_t remaining = header.numOfEdges;
+    try{
+        while(remaining > 0){
+            std::size_t count = remaining < blockRecords ? (std::size_t)remaining : blockRecords;
+            in.read(block, count * recordSize);
+            if((std::size_t)in.gcount() != count * recordSize){
+                throw std::invalid_argument("Unexpected end of the graph binary file.");
+            }
+            const char* record = block;
+            for(std::size_t i = 0; i < count; i++){
+                V src;
+                V dest;
+                W weight;
+                std::memcpy(&src, record, sizeof(V));
+                std::memcpy(&dest, record + sizeof(V), sizeof(V));
+                std::memcpy(&weight, record + 2 * sizeof(V), sizeof(W));
+                record += recordSize;
+                records.push_back(Record(Pair<V, V>(src, dest), weight));
+            }
+            remaining -= count;
+        }
+    }
+    catch(...){
+        delete[] block;
+        throw;
+    }
+    delete[] block;
+
+    G g((V)header.numOfVertices);
+    if(g.appendUniqueEdges(records).invalid > 0){
+        throw std::invalid_argument("Corrupted graph binary file.");
+    }
+    DynamicArray<V> targets;
+    for(V v = 1; v <= g.getNumOfVertices(); v++){
+        if(g.neighbors(v).getSize() < 2) continue;
+        targets.clear();
+        for(const auto& edge : g.neighbors(v)){
+            targets.push_back(edgeTarget(edge));
+        }
+        std::sort(targets.begin(), targets.end());
+        for(int i = 1; i < targets.getSize(); i++){
+            if(targets[i - 1] == targets[i]){
+                throw std::invalid_argument("Corrupted graph binary file.");
+            }
+        }
+    }
+    return g;
+}
+
+template <typename G>
+G graph::readBinary(const std::string& path){
+    std::ifstream file(path, std::ios::binary);
+    if(!file){
+        throw std::invalid_argument("Cannot open the file " + path + ".");
+    }
+    return readBinary<G>(file);
+}
+
+// The same graph types as the algorithms
+#define INSTANTIATE_WRITERS(G) \
+    template void graph::writeEdgeList<G>(const G& g, std::ostream& out, ThreadPool* pool); \
+    template void graph::writeEdgeList<G>(const G& g, const std::string& path, ThreadPool* pool); \
+    template void graph::writeDot<G>(const G& g, std::ostream& out, bool directed, ThreadPool* pool); \
+    template void graph::writeDot<G>(const G& g, const std::string& path, bool directed, ThreadPool* pool); \
+    template void graph::writeBinary<G>(const G& g, std::ostream& out); \
+    template void graph::writeBinary<G>(const G& g, const std::string& path);
+
+#define INSTANTIATE_READERS(G) \
+    template BinaryHeader graph::readBinaryHeader<G>(std::istream& in); \
+    template G graph::readBinary<G>(std::istream& in); \
+    template G graph::readBinary<G>(const std::string& path);
+
+using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+using GraphF32 = BasicGraph<uint32_t, float>;
+using GraphI64 = BasicGraph<uint32_t, int64_t>;
+using CompressedGraphU8 = BasicCompressedGraph<uint32_t, uint8_t>;
+using CompressedGraphF32 = BasicCompressedGraph<uint32_t, float>;
+using CompressedGraphI64 = BasicCompressedGraph<uint32_t, int64_t>;
+using UnweightedGraphU32 = BasicGraph<uint32_t, uint32_t, Unweighted>;
+
+INSTANTIATE_WRITERS(Graph)
+INSTANTIATE_WRITERS(CompressedGraph)
+INSTANTIATE_WRITERS(GraphU8)
+INSTANTIATE_WRITERS(GraphF32)
+INSTANTIATE_WRITERS(GraphI64)
+INSTANTIATE_WRITERS(CompressedGraphU8)
+INSTANTIATE_WRITERS(CompressedGraphF32)
+INSTANTIATE_WRITERS(CompressedGraphI64)
+INSTANTIATE_WRITERS(UnweightedGraph)
+INSTANTIATE_WRITERS(UnweightedGraphU32)
+
+INSTANTIATE_READERS(Graph)
+INSTANTIATE_READERS(GraphU8)
+INSTANTIATE_READERS(GraphF32)
+INSTANTIATE_READERS(GraphI64)
+INSTANTIATE_READERS(UnweightedGraph)
+INSTANTIATE_READERS(UnweightedGraphU32)
+
+#undef INSTANTIATE_WRITERS
+#undef INSTANTIATE_READERS
@@ -0,0 +1,67 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include "Graph.hpp"
+#include "CompressedGraph.hpp"
+#include "ThreadPool.hpp"
+
+namespace graph {
+
+    /*
+    Exporters for any graph type G that offers getNumOfVertices() and neighbors(v) (Graph, CompressedGraph, ...).
+    The output is formatted with std::to_chars into a large buffer that is written to the stream in big blocks,
+    nothing goes through operator<< or std::endl.
+    With a pool the text formats are formatted in parallel: the vertices are split into chunks,
+    every wave of chunks is formatted by the workers and then written in order, so the output is the same.
+    Every directed entry is one edge of the output, an undirected edge appears in both directions
+    (except in writeDot with directed = false).
+    The path overloads throw std::invalid_argument if the file can't be opened.
+    */
+
+    // "src dest weight" lines
+    template <typename G>
+    void writeEdgeList(const G& g, std::ostream& out, ThreadPool* pool = nullptr);
+    template <typename G>
+    void writeEdgeList(const G& g, const std::string& path, ThreadPool* pool = nullptr);
+
+    // Graphviz DOT, directed = false writes a "graph" with every edge once (from the smaller id)
+    template <typename G>
+    void writeDot(const G& g, std::ostream& out, bool directed = true, ThreadPool* pool = nullptr);
+    template <typename G>
+    void writeDot(const G& g, const std::string& path, bool directed = true, ThreadPool* pool = nullptr);
+
+    /*
+    Binary edge file (native byte order):
+    header - "SP2E", uint32 version, uint32 sizeof(V), uint32 sizeof(W), uint64 vertices, uint64 edges
+    then one (V src, V dest, W weight) record per directed entry, grouped by src in increasing order
+    */
+    struct BinaryHeader{
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t weightSize;
+        uint64_t numOfVertices;
+        uint64_t numOfEdges;
+    };
+
+    template <typename G>
+    void writeBinary(const G& g, std::ostream& out);
+    template <typename G>
+    void writeBinary(const G& g, const std::string& path);
+
+    // G is a BasicGraph with the vertex and weight types of the file, throws std::invalid_argument on a bad file
+    template <typename G>
+    G readBinary(std::istream& in);
+    // reads and checks only the header, the stream is left at the first record
+    template <typename G>
+    BinaryHeader readBinaryHeader(std::istream& in);
+    template <typename G>
+    G readBinary(const std::string& path);
+
+}  // namespace graph
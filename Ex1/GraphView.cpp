@@ -0,0 +1,171 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <stdexcept>
+#include "GraphView.hpp"
+
+using namespace graph;
+
+// the kept edges of every vertex, as one list for appendUniqueEdges
+template <typename View>
+static BasicGraph<typename View::vertex_type, typename View::weight_type, typename View::policy_type> copyKeptEdges(const View& view){
+    using V = typename View::vertex_type;
+    using W = typename View::weight_type;
+    DynamicArray<Pair<Pair<V, V>, W>> edges;
+    for(V v = 1; v <= view.getNumOfVertices(); v++){
+        for(const typename View::edge_type& edge : view.neighbors(v)){
+            edges.push_back(Pair<Pair<V, V>, W>(Pair<V, V>(v, edgeTarget(edge)), edgeWeight<W>(edge)));
+        }
+    }
+    BasicGraph<V, W, typename View::policy_type> g(view.getNumOfVertices());
+    g.appendUniqueEdges(edges);     // the lists of the graph never hold duplicates
+    return g;
+}
+
+//////////////////////////////////////////
+// BasicSubgraphView
+//////////////////////////////////////////
+template <typename V, typename W, typename P>
+BasicSubgraphView<V, W, P>::BasicSubgraphView(const BasicGraph<V, W, P>& g, const DynamicArray<V>& vertices){
+    this->g = &g;
+    long words = ((long)g.getNumOfVertices() + 63) / 64;
+    selected.reserve(words > 0 ? (int)words : 1);
+    for(long i = 0; i < words; i++){
+        selected.push_back(0);
+    }
+    numOfSelected = 0;
+    for(const V& vertex : vertices){
+        if(vertex < 1 || vertex > g.getNumOfVertices()){
+            throw std::invalid_argument("Invalid vertex.");
+        }
+        if(!contains(vertex)){
+            long index = (long)vertex - 1;
+            selected[index >> 6] |= (uint64_t)1 << (index & 63);
+            numOfSelected++;
+        }
+    }
+
+    // exact, so dijkstra and prim accept a subgraph that leaves all the negative edges out
+    negativeEdge = false;
+    if(g.hasNegativeEdge()){
+        for(const V& vertex : vertices){
+            for(const edge_type& edge : neighbors(vertex)){
+                if(edgeWeight<W>(edge) < W(0)){
+                    negativeEdge = true;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+template <typename V, typename W, typename P>
+V BasicSubgraphView<V, W, P>::getNumOfVertices() const{
+    return g->getNumOfVertices();
+}
+
+template <typename V, typename W, typename P>
+V BasicSubgraphView<V, W, P>::getNumOfSelected() const{
+    return numOfSelected;
+}
+
+template <typename V, typename W, typename P>
+FilteredNeighbors<BasicSubgraphView<V, W, P>> BasicSubgraphView<V, W, P>::neighbors(V vertex) const{
+    if(vertex < 1 || vertex > g->getNumOfVertices()){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    if(!contains(vertex)){
+        return FilteredNeighbors<BasicSubgraphView>(ArrayView<edge_type>(nullptr, 0), this, vertex);
+    }
+    return FilteredNeighbors<BasicSubgraphView>(g->neighbors(vertex), this, vertex);
+}
+
+template <typename V, typename W, typename P>
+bool BasicSubgraphView<V, W, P>::hasNegativeEdge() const{
+    return negativeEdge;
+}
+
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P> BasicSubgraphView<V, W, P>::toGraph() const{
+    return copyKeptEdges(*this);
+}
+
+//////////////////////////////////////////
+// BasicEdgeFilterView
+//////////////////////////////////////////
+template <typename V, typename W, typename P>
+BasicEdgeFilterView<V, W, P>::BasicEdgeFilterView(const BasicGraph<V, W, P>& g, W minWeight, W maxWeight){
+    this->g = &g;
+    this->minWeight = minWeight;
+    this->maxWeight = maxWeight;
+    this->hasPredicate = false;
+    findNegativeEdge();
+}
+
+template <typename V, typename W, typename P>
+BasicEdgeFilterView<V, W, P>::BasicEdgeFilterView(const BasicGraph<V, W, P>& g, EdgePredicate<V, W> predicate, W minWeight, W maxWeight)
+    : predicate(predicate){
+    this->g = &g;
+    this->minWeight = minWeight;
+    this->maxWeight = maxWeight;
+    this->hasPredicate = true;
+    findNegativeEdge();
+}
+
+// the edges are scanned only when a kept edge may be negative
+template <typename V, typename W, typename P>
+void BasicEdgeFilterView<V, W, P>::findNegativeEdge(){
+    negativeEdge = false;
+    if(!g->hasNegativeEdge() || !(minWeight < W(0))){
+        return;
+    }
+    W smallest = g->getMinWeight();
+    if(!hasPredicate && !(smallest < minWeight) && !(maxWeight < smallest)){
+        negativeEdge = true;    // the graph's smallest weight is negative and in the range
+        return;
+    }
+    for(V v = 1; v <= g->getNumOfVertices(); v++){
+        for(const edge_type& edge : neighbors(v)){
+            if(edgeWeight<W>(edge) < W(0)){
+                negativeEdge = true;
+                return;
+            }
+        }
+    }
+}
+
+template <typename V, typename W, typename P>
+V BasicEdgeFilterView<V, W, P>::getNumOfVertices() const{
+    return g->getNumOfVertices();
+}
+
+template <typename V, typename W, typename P>
+FilteredNeighbors<BasicEdgeFilterView<V, W, P>> BasicEdgeFilterView<V, W, P>::neighbors(V vertex) const{
+    return FilteredNeighbors<BasicEdgeFilterView>(g->neighbors(vertex), this, vertex);
+}
+
+template <typename V, typename W, typename P>
+bool BasicEdgeFilterView<V, W, P>::hasNegativeEdge() const{
+    return negativeEdge;
+}
+
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P> BasicEdgeFilterView<V, W, P>::toGraph() const{
+    return copyKeptEdges(*this);
+}
+
+// The same (vertex id, weight) combinations as BasicGraph
+template class graph::BasicSubgraphView<int, int>;
+template class graph::BasicSubgraphView<uint32_t, uint8_t>;
+template class graph::BasicSubgraphView<uint32_t, float>;
+template class graph::BasicSubgraphView<uint32_t, int64_t>;
+template class graph::BasicSubgraphView<int, int, graph::Unweighted>;
+template class graph::BasicSubgraphView<uint32_t, uint32_t, graph::Unweighted>;
+template class graph::BasicEdgeFilterView<int, int>;
+template class graph::BasicEdgeFilterView<uint32_t, uint8_t>;
+template class graph::BasicEdgeFilterView<uint32_t, float>;
+template class graph::BasicEdgeFilterView<uint32_t, int64_t>;
+template class graph::BasicEdgeFilterView<int, int, graph::Unweighted>;
+template class graph::BasicEdgeFilterView<uint32_t, uint32_t, graph::Unweighted>;
@@ -0,0 +1,235 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "Graph.hpp"
+
+namespace graph {
+
+    /*
+    Read-only views of a BasicGraph that hide some of its edges without copying anything.
+    The views keep the vertex ids of the graph (a hidden vertex just has no edges), and the edges are
+    filtered while the algorithms iterate the neighbors, so bfs, dijkstra, etc. run directly on a view.
+    A view holds a reference to the graph, which must not change while the view is used.
+    */
+
+    // The neighbors of one vertex that the view keeps, View::keeps(src, edge) decides
+    template <typename View>
+    class FilteredNeighbors{
+    public:
+        using vertex_type = typename View::vertex_type;
+        using edge_type = typename View::edge_type;
+
+        class Iterator{
+        private:
+            const edge_type* pos;
+            const edge_type* last;
+            const View* view;
+            vertex_type src;
+
+            void skip();
+
+        public:
+            Iterator(const edge_type* pos, const edge_type* last, const View* view, vertex_type src);
+            const edge_type& operator*() const;
+            const edge_type* operator->() const;
+            Iterator& operator++();
+            bool operator!=(const Iterator& other) const;
+            bool operator==(const Iterator& other) const;
+        };  // class Iterator
+
+    private:
+        ArrayView<edge_type> edges;     // all the neighbors in the graph
+        const View* view;
+        vertex_type src;
+
+    public:
+        FilteredNeighbors(ArrayView<edge_type> edges, const View* view, vertex_type src);
+        Iterator begin() const;
+        Iterator end() const;
+    };  // class FilteredNeighbors
+
+    /*
+    The subgraph induced by a set of vertices - only the edges between two selected vertices are kept.
+    Costs one bit per vertex.
+    */
+    template <typename V, typename W, typename P = Weighted>
+    class BasicSubgraphView{
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using policy_type = P;
+        using edge_type = typename P::template Entry<V, W>;
+
+    private:
+        const BasicGraph<V, W, P>* g;
+        DynamicArray<uint64_t> selected;    // bit (v - 1) is set if vertex v is in the subgraph
+        V numOfSelected;
+        bool negativeEdge;
+
+    public:
+        // throws if a vertex is out of range, repeated vertices are fine
+        BasicSubgraphView(const BasicGraph<V, W, P>& g, const DynamicArray<V>& vertices);
+
+        V getNumOfVertices() const;     // of the graph, the ids don't change
+        V getNumOfSelected() const;
+        bool contains(V vertex) const;  // vertex must be in range
+        bool keeps(V src, const edge_type& edge) const;
+        FilteredNeighbors<BasicSubgraphView> neighbors(V vertex) const;
+        bool hasNegativeEdge() const;   // only the kept edges count
+        BasicGraph<V, W, P> toGraph() const;    // a copy of the kept edges, without the duplicate scans of addEdge
+
+    };  // class BasicSubgraphView
+
+    /*
+    An edge predicate owned by the view: bool predicate(V src, V dest, W weight), false hides the edge.
+    The callable is copied (or moved) in, so an inline lambda is fine; only what it captures by reference
+    must outlive the view.
+    */
+    template <typename V, typename W>
+    class EdgePredicate{
+    private:
+        std::function<bool(V, V, W)> predicate;
+
+    public:
+        EdgePredicate() = default;      // no predicate, must not be called
+
+        template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, EdgePredicate>::value>::type>
+        EdgePredicate(F&& predicate) : predicate(std::forward<F>(predicate)){}
+
+        bool operator()(V src, V dest, W weight) const{
+            return predicate(src, dest, weight);
+        }
+    };
+
+    // The edges with a weight in [minWeight, maxWeight] that pass the predicate (if there is one)
+    template <typename V, typename W, typename P = Weighted>
+    class BasicEdgeFilterView{
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using policy_type = P;
+        using edge_type = typename P::template Entry<V, W>;
+
+    private:
+        const BasicGraph<V, W, P>* g;
+        W minWeight;
+        W maxWeight;
+        bool hasPredicate;
+        EdgePredicate<V, W> predicate;
+        bool negativeEdge;
+
+        void findNegativeEdge();
+
+    public:
+        BasicEdgeFilterView(const BasicGraph<V, W, P>& g, W minWeight = std::numeric_limits<W>::lowest(),
+                            W maxWeight = std::numeric_limits<W>::max());
+        BasicEdgeFilterView(const BasicGraph<V, W, P>& g, EdgePredicate<V, W> predicate,
+                            W minWeight = std::numeric_limits<W>::lowest(), W maxWeight = std::numeric_limits<W>::max());
+
+        V getNumOfVertices() const;
+        bool keeps(V src, const edge_type& edge) const;
+        FilteredNeighbors<BasicEdgeFilterView> neighbors(V vertex) const;
+        bool hasNegativeEdge() const;   // only the kept edges count
+        BasicGraph<V, W, P> toGraph() const;    // a copy of the kept edges, without the duplicate scans of addEdge
+
+    };  // class BasicEdgeFilterView
+
+    using SubgraphView = BasicSubgraphView<int, int>;
+    using EdgeFilterView = BasicEdgeFilterView<int, int>;
+    using UnweightedSubgraphView = BasicSubgraphView<int, int, Unweighted>;
+
+
+//////////////////////////////////////////
+// FilteredNeighbors
+//////////////////////////////////////////
+// The iterator and keeps() are defined here so the filtering can be inlined into the algorithms
+
+template <typename View>
+FilteredNeighbors<View>::Iterator::Iterator(const edge_type* pos, const edge_type* last, const View* view, vertex_type src){
+    this->pos = pos;
+    this->last = last;
+    this->view = view;
+    this->src = src;
+    skip();
+}
+
+template <typename View>
+void FilteredNeighbors<View>::Iterator::skip(){
+    while(pos != last && !view->keeps(src, *pos)){
+        pos++;
+    }
+}
+
+template <typename View>
+const typename FilteredNeighbors<View>::edge_type& FilteredNeighbors<View>::Iterator::operator*() const{
+    return *pos;
+}
+
+template <typename View>
+const typename FilteredNeighbors<View>::edge_type* FilteredNeighbors<View>::Iterator::operator->() const{
+    return pos;
+}
+
+template <typename View>
+typename FilteredNeighbors<View>::Iterator& FilteredNeighbors<View>::Iterator::operator++(){
+    pos++;
+    skip();
+    return *this;
+}
+
+template <typename View>
+bool FilteredNeighbors<View>::Iterator::operator!=(const Iterator& other) const{
+    return pos != other.pos;
+}
+
+template <typename View>
+bool FilteredNeighbors<View>::Iterator::operator==(const Iterator& other) const{
+    return pos == other.pos;
+}
+
+template <typename View>
+FilteredNeighbors<View>::FilteredNeighbors(ArrayView<edge_type> edges, const View* view, vertex_type src)
+    : edges(edges), view(view), src(src){}
+
+template <typename View>
+typename FilteredNeighbors<View>::Iterator FilteredNeighbors<View>::begin() const{
+    return Iterator(edges.begin(), edges.end(), view, src);
+}
+
+// the end is never filtered, so it doesn't call keeps()
+template <typename View>
+typename FilteredNeighbors<View>::Iterator FilteredNeighbors<View>::end() const{
+    return Iterator(edges.end(), edges.end(), view, src);
+}
+
+template <typename V, typename W, typename P>
+bool BasicSubgraphView<V, W, P>::contains(V vertex) const{
+    long index = (long)vertex - 1;
+    return (selected.begin()[index >> 6] >> (index & 63)) & 1;    // no bounds check, the ids come from the graph
+}
+
+template <typename V, typename W, typename P>
+bool BasicSubgraphView<V, W, P>::keeps(V src, const edge_type& edge) const{
+    (void)src;
+    return contains(edgeTarget(edge));
+}
+
+template <typename V, typename W, typename P>
+bool BasicEdgeFilterView<V, W, P>::keeps(V src, const edge_type& edge) const{
+    W weight = edgeWeight<W>(edge);
+    if(weight < minWeight || weight > maxWeight){
+        return false;
+    }
+    return !hasPredicate || predicate(src, edgeTarget(edge), weight);
+}
+
+}  // namespace graph
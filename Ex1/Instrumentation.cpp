@@ -0,0 +1,137 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <cstring>
+#include <iomanip>
+#include "Instrumentation.hpp"
+
+using namespace graph;
+
+AlgorithmStats::AlgorithmStats(){
+    epoch = std::chrono::steady_clock::now();
+}
+
+double AlgorithmStats::nowUs() const{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void AlgorithmStats::phaseBegin(const char* name){
+    phases.push_back({name, nowUs(), -1});
+}
+
+void AlgorithmStats::phaseEnd(){
+    for(int i = phases.getSize() - 1; i >= 0; i--){
+        if(phases[i].durationUs < 0){
+            phases[i].durationUs = nowUs() - phases[i].startUs;
+            return;
+        }
+    }
+}
+
+const DynamicArray<AlgorithmStats::Phase>& AlgorithmStats::getPhases() const{
+    return phases;
+}
+
+double AlgorithmStats::phaseTotalUs(const char* name) const{
+    double total = 0;
+    for(int i = 0; i < phases.getSize(); i++){
+        if(phases[i].durationUs >= 0 && std::strcmp(phases[i].name, name) == 0){
+            total += phases[i].durationUs;
+        }
+    }
+    return total;
+}
+
+void AlgorithmStats::reset(){
+    edgesScanned = 0;
+    relaxations = 0;
+    heapPushes = 0;
+    heapPops = 0;
+    stalePops = 0;
+    findCalls = 0;
+    unionCalls = 0;
+    allocations = 0;
+    allocatedBytes = 0;
+    phases.clear();
+    epoch = std::chrono::steady_clock::now();
+}
+
+void AlgorithmStats::print(std::ostream& out) const{
+    out << "edges scanned: " << edgesScanned << std::endl;
+    out << "relaxations: " << relaxations << std::endl;
+    out << "heap pushes: " << heapPushes << ", pops: " << heapPops << ", stale pops: " << stalePops << std::endl;
+    out << "find calls: " << findCalls << ", union calls: " << unionCalls << std::endl;
+    out << "allocations: " << allocations << " (" << allocatedBytes << " bytes)" << std::endl;
+    for(int i = 0; i < phases.getSize(); i++){
+        out << phases[i].name << ": " << phases[i].durationUs << " us" << std::endl;
+    }
+}
+
+/*
+The phase names are string literals of the algorithms, so they never need escaping.
+An open phase is written with the time until now.
+*/
+void AlgorithmStats::writeChromeTrace(std::ostream& out) const{
+    double end = nowUs();
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\": [\n";
+    for(int i = 0; i < phases.getSize(); i++){
+        double duration = phases[i].durationUs >= 0 ? phases[i].durationUs : end - phases[i].startUs;
+        out << "  {\"name\": \"" << phases[i].name << "\", \"cat\": \"algorithm\", \"ph\": \"X\", \"ts\": " << phases[i].startUs
+            << ", \"dur\": " << duration << ", \"pid\": 1, \"tid\": 1},\n";
+    }
+    out << "  {\"name\": \"counters\", \"ph\": \"C\", \"ts\": " << end << ", \"pid\": 1, \"tid\": 1, \"args\": {"
+        << "\"edgesScanned\": " << edgesScanned << ", \"relaxations\": " << relaxations
+        << ", \"heapPushes\": " << heapPushes << ", \"heapPops\": " << heapPops << ", \"stalePops\": " << stalePops
+        << ", \"findCalls\": " << findCalls << ", \"unionCalls\": " << unionCalls
+        << ", \"allocations\": " << allocations << ", \"allocatedBytes\": " << allocatedBytes << "}}\n";
+    out << "], \"displayTimeUnit\": \"ms\"}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+//////////////////////////////////////////
+// AllocationScope
+//////////////////////////////////////////
+// trivial, so the thread local needs no construction and is safe to use inside operator new
+static thread_local detail::HeapCounters threadHeap = {0, 0, 0};
+
+std::atomic<bool> detail::allocationHookInstalled(false);
+
+detail::HeapCounters& detail::heapCounters(){
+    return threadHeap;
+}
+
+AllocationScope::AllocationScope(){
+    base = threadHeap.current;
+    outerPeak = threadHeap.peak;
+    baseAllocations = threadHeap.allocations;
+    threadHeap.peak = threadHeap.current;
+}
+
+// the outer scope sees the peak of this one as well
+AllocationScope::~AllocationScope(){
+    if(outerPeak > threadHeap.peak){
+        threadHeap.peak = outerPeak;
+    }
+}
+
+bool AllocationScope::enabled(){
+    return detail::allocationHookInstalled.load(std::memory_order_relaxed);
+}
+
+std::size_t AllocationScope::peakBytes() const{
+    return threadHeap.peak > base ? (std::size_t)(threadHeap.peak - base) : 0;
+}
+
+long long AllocationScope::currentBytes() const{
+    return threadHeap.current - base;
+}
+
+long long AllocationScope::allocations() const{
+    return threadHeap.allocations - baseAllocations;
+}
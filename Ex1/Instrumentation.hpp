@@ -0,0 +1,123 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include "Data_Structures.hpp"
+
+namespace graph {
+
+    /*
+    Counters policies for the algorithms (the last template parameter of bfs, dfs, dijkstra, prim and kruskal).
+    The algorithms call the hooks below at the interesting points; with NullCounters (the default) every hook
+    is an empty inline function, so the instrumentation is compiled out and costs nothing.
+    */
+    struct NullCounters{
+        void edgeScanned(){}
+        void relaxation(){}
+        void heapPush(){}
+        void heapPop(){}
+        void stalePop(){}
+        void findCall(){}
+        void unionCall(){}
+        void allocation(std::size_t){}
+        void phaseBegin(const char*){}
+        void phaseEnd(){}
+    };
+
+    /*
+    Counts everything and records the phases of every run.
+    One object can collect several runs, the counters add up and the phases keep their order.
+    Not thread safe - use one object per thread.
+    */
+    class AlgorithmStats{
+    public:
+        struct Phase{
+            const char* name;   // a string literal of the algorithm
+            double startUs;     // since the stats object was created (or reset)
+            double durationUs;  // negative while the phase is open
+        };
+
+        long long edgesScanned = 0;     // adjacency entries read
+        long long relaxations = 0;      // distances / keys that improved
+        long long heapPushes = 0;
+        long long heapPops = 0;
+        long long stalePops = 0;        // popped entries of vertices that were already finished
+        long long findCalls = 0;        // top level finds of the disjoint set (not the recursion of the path compression)
+        long long unionCalls = 0;
+        long long allocations = 0;      // working arrays allocated by the algorithm (the result is not counted)
+        long long allocatedBytes = 0;
+
+    private:
+        DynamicArray<Phase> phases;
+        std::chrono::steady_clock::time_point epoch;
+
+        double nowUs() const;
+
+    public:
+        AlgorithmStats();
+
+        void edgeScanned(){ edgesScanned++; }
+        void relaxation(){ relaxations++; }
+        void heapPush(){ heapPushes++; }
+        void heapPop(){ heapPops++; }
+        void stalePop(){ stalePops++; }
+        void findCall(){ findCalls++; }
+        void unionCall(){ unionCalls++; }
+        void allocation(std::size_t bytes){ allocations++; allocatedBytes += bytes; }
+        void phaseBegin(const char* name);
+        void phaseEnd();        // ends the last phase that is still open
+
+        const DynamicArray<Phase>& getPhases() const;
+        double phaseTotalUs(const char* name) const;    // the time of all the phases with this name
+        void reset();
+
+        void print(std::ostream& out) const;
+        // Chrome trace event format (chrome://tracing, Perfetto): every phase is a complete event
+        // and the counters are one counter event at the end
+        void writeChromeTrace(std::ostream& out) const;
+    };  // class AlgorithmStats
+
+    /*
+    Heap usage of the calling thread, counted by the global operator new / delete replaced in AllocationHook.cpp.
+    The hook is opt-in: it works only in programs that link AllocationHook.cpp (the tests and the benchmark do),
+    otherwise enabled() is false and every scope reports 0.
+    Memory freed by another thread is subtracted there, so measure code that runs on the calling thread.
+    */
+    namespace detail{
+        struct HeapCounters{
+            long long current;      // bytes allocated and not yet freed (may drop below 0, see above)
+            long long peak;         // the highest current since the innermost scope started
+            long long allocations;
+        };
+        HeapCounters& heapCounters();
+        extern std::atomic<bool> allocationHookInstalled;
+    }
+
+    // Peak heap growth while the scope is alive (e.g. around one algorithm call), scopes can be nested
+    class AllocationScope{
+    private:
+        long long base;
+        long long outerPeak;
+        long long baseAllocations;
+
+    public:
+        AllocationScope();
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope& other) = delete;
+        AllocationScope& operator=(const AllocationScope& other) = delete;
+
+        static bool enabled();
+        std::size_t peakBytes() const;      // the highest heap usage above the start, so far
+        long long currentBytes() const;     // the heap usage above the start now (negative if more was freed)
+        long long allocations() const;      // calls to operator new since the start
+    };  // class AllocationScope
+
+}  // namespace graph
@@ -0,0 +1,249 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include "PageRank.hpp"
+#include "CompressedGraph.hpp"
+#include "VersionedGraph.hpp"
+
+using namespace graph;
+
+static const long BLOCK = 4096;     // vertices per block, also the unit of the parallel split
+
+// runs body(block) for every block, on the pool if there is one
+template <typename F>
+static void forEachBlock(long numBlocks, ThreadPool* pool, F&& body){
+    if(pool != nullptr){
+        pool->parallel_for(0, numBlocks, body, 1);
+    }
+    else{
+        for(long block = 0; block < numBlocks; block++){
+            body(block);
+        }
+    }
+}
+
+//////////////////////////////////////////
+// PageRankEngine
+//////////////////////////////////////////
+// counting sort of the edges by target, the sources of every vertex end up in increasing order
+template <typename V>
+template <typename G>
+PageRankEngine<V>::PageRankEngine(G& g){
+    numOfVertices = g.getNumOfVertices();
+    long n = (long)numOfVertices;
+    offsets.reserve((int)n + 1);
+    outShare.reserve(n > 0 ? (int)n : 1);
+    for(long i = 0; i <= n; i++){
+        offsets.push_back(0);
+    }
+    for(V u = 1; u <= numOfVertices; u++){
+        int degree = 0;
+        for(const auto& edge : g.neighbors(u)){
+            offsets[(int)edgeTarget(edge)]++;
+            degree++;
+        }
+        outShare.push_back(degree > 0 ? 1.0 / degree : 0.0);
+    }
+    for(long i = 1; i <= n; i++){
+        offsets[(int)i] += offsets[(int)i - 1];
+    }
+    numOfEdges = offsets[(int)n];
+
+    DynamicArray<long long> cursor(n > 0 ? (int)n : 1);
+    for(long i = 0; i < n; i++){
+        cursor.push_back(offsets[(int)i]);
+    }
+    sources.reserve(numOfEdges > 0 ? (int)numOfEdges : 1);
+    for(long long i = 0; i < numOfEdges; i++){
+        sources.push_back(0);
+    }
+    V* filled = sources.begin();
+    long long* next = cursor.begin();
+    for(V u = 1; u <= numOfVertices; u++){
+        for(const auto& edge : g.neighbors(u)){
+            filled[next[edgeTarget(edge) - 1]++] = u;
+        }
+    }
+}
+
+template <typename V>
+V PageRankEngine<V>::getNumOfVertices() const{
+    return numOfVertices;
+}
+
+template <typename V>
+long long PageRankEngine<V>::getNumOfEdges() const{
+    return numOfEdges;
+}
+
+/*
+rank'(v) = teleport(v) * ((1 - d) + d * dangling) + d * sum of share(u) over the sources u of v,
+where share(u) = rank(u) / outDegree(u) and dangling is the total rank of the vertices without out edges
+*/
+template <typename V>
+PageRankResult PageRankEngine<V>::solve(const DynamicArray<double>& teleport, const PageRankOptions& options) const{
+    if(!(options.damping >= 0 && options.damping < 1)){
+        throw std::invalid_argument("The damping factor must be in [0, 1).");
+    }
+    if(!(options.tolerance >= 0) || options.maxIterations < 1){
+        throw std::invalid_argument("Invalid PageRank options.");
+    }
+    PageRankResult result;
+    long n = (long)numOfVertices;
+    if(n == 0){
+        result.converged = true;
+        return result;
+    }
+
+    DynamicArray<double> rank(teleport);
+    DynamicArray<double> next(teleport);
+    DynamicArray<double> share(teleport);
+    long numBlocks = (n + BLOCK - 1) / BLOCK;
+    DynamicArray<double> blockDangling((int)numBlocks);
+    DynamicArray<double> blockResidual((int)numBlocks);
+    for(long b = 0; b < numBlocks; b++){
+        blockDangling.push_back(0);
+        blockResidual.push_back(0);
+    }
+
+    const long long* first = offsets.begin();
+    const V* from = sources.begin();
+    const double* out = outShare.begin();
+    const double* tele = teleport.begin();
+    double* dangling = blockDangling.begin();
+    double* residual = blockResidual.begin();
+    double d = options.damping;
+
+    while(result.iterations < options.maxIterations){
+        const double* current = rank.begin();
+        double* shares = share.begin();
+        forEachBlock(numBlocks, options.pool, [&](long block){
+            long end = (block + 1) * BLOCK < n ? (block + 1) * BLOCK : n;
+            double sum = 0;
+            for(long u = block * BLOCK; u < end; u++){
+                shares[u] = current[u] * out[u];
+                if(out[u] == 0) sum += current[u];
+            }
+            dangling[block] = sum;
+        });
+        double danglingRank = 0;
+        for(long b = 0; b < numBlocks; b++){
+            danglingRank += dangling[b];
+        }
+        double base = (1 - d) + d * danglingRank;
+
+        double* updated = next.begin();
+        forEachBlock(numBlocks, options.pool, [&](long block){
+            long end = (block + 1) * BLOCK < n ? (block + 1) * BLOCK : n;
+            double change = 0;
+            for(long v = block * BLOCK; v < end; v++){
+                // four independent sums, so the additions of a long list overlap
+                double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                long long i = first[v];
+                long long last = first[v + 1];
+                for(; i + 4 <= last; i += 4){
+                    s0 += shares[from[i] - 1];
+                    s1 += shares[from[i + 1] - 1];
+                    s2 += shares[from[i + 2] - 1];
+                    s3 += shares[from[i + 3] - 1];
+                }
+                for(; i < last; i++){
+                    s0 += shares[from[i] - 1];
+                }
+                double value = tele[v] * base + d * ((s0 + s1) + (s2 + s3));
+                change += std::fabs(value - current[v]);
+                updated[v] = value;
+            }
+            residual[block] = change;
+        });
+        result.residual = 0;
+        for(long b = 0; b < numBlocks; b++){
+            result.residual += residual[b];
+        }
+        std::swap(rank, next);
+        result.iterations++;
+        if(result.residual < options.tolerance){
+            result.converged = true;
+            break;
+        }
+    }
+    result.ranks = std::move(rank);
+    return result;
+}
+
+template <typename V>
+PageRankResult PageRankEngine<V>::pageRank(const PageRankOptions& options) const{
+    long n = (long)numOfVertices;
+    DynamicArray<double> teleport(n > 0 ? (int)n : 1);
+    for(long v = 0; v < n; v++){
+        teleport.push_back(1.0 / n);
+    }
+    return solve(teleport, options);
+}
+
+template <typename V>
+PageRankResult PageRankEngine<V>::personalizedPageRank(const DynamicArray<V>& seeds, const PageRankOptions& options) const{
+    if(seeds.getSize() == 0){
+        throw std::invalid_argument("Personalized PageRank needs at least one seed.");
+    }
+    long n = (long)numOfVertices;
+    DynamicArray<double> teleport(n > 0 ? (int)n : 1);
+    for(long v = 0; v < n; v++){
+        teleport.push_back(0);
+    }
+    for(const V& seed : seeds){
+        if(seed < 1 || seed > numOfVertices){
+            throw std::invalid_argument("Invalid seed vertex.");
+        }
+        teleport[(int)seed - 1] += 1.0 / seeds.getSize();
+    }
+    return solve(teleport, options);
+}
+
+template <typename G>
+PageRankResult graph::pageRank(G& g, const PageRankOptions& options){
+    return PageRankEngine<typename G::vertex_type>(g).pageRank(options);
+}
+
+template <typename G>
+PageRankResult graph::personalizedPageRank(G& g, const DynamicArray<typename G::vertex_type>& seeds, const PageRankOptions& options){
+    return PageRankEngine<typename G::vertex_type>(g).personalizedPageRank(seeds, options);
+}
+
+template class graph::PageRankEngine<int>;
+template class graph::PageRankEngine<uint32_t>;
+
+// The same graph types as the algorithms
+#define INSTANTIATE_PAGERANK(G) \
+    template PageRankEngine<G::vertex_type>::PageRankEngine(G& g); \
+    template PageRankResult graph::pageRank<G>(G& g, const PageRankOptions& options); \
+    template PageRankResult graph::personalizedPageRank<G>(G& g, const DynamicArray<typename G::vertex_type>& seeds, \
+                                                           const PageRankOptions& options);
+
+using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+using GraphF32 = BasicGraph<uint32_t, float>;
+using GraphI64 = BasicGraph<uint32_t, int64_t>;
+using CompressedGraphU8 = BasicCompressedGraph<uint32_t, uint8_t>;
+using CompressedGraphF32 = BasicCompressedGraph<uint32_t, float>;
+using CompressedGraphI64 = BasicCompressedGraph<uint32_t, int64_t>;
+using UnweightedGraphU32 = BasicGraph<uint32_t, uint32_t, Unweighted>;
+
+INSTANTIATE_PAGERANK(Graph)
+INSTANTIATE_PAGERANK(CompressedGraph)
+INSTANTIATE_PAGERANK(GraphU8)
+INSTANTIATE_PAGERANK(GraphF32)
+INSTANTIATE_PAGERANK(GraphI64)
+INSTANTIATE_PAGERANK(CompressedGraphU8)
+INSTANTIATE_PAGERANK(CompressedGraphF32)
+INSTANTIATE_PAGERANK(CompressedGraphI64)
+INSTANTIATE_PAGERANK(UnweightedGraph)
+INSTANTIATE_PAGERANK(UnweightedGraphU32)
+INSTANTIATE_PAGERANK(GraphSnapshot)
+INSTANTIATE_PAGERANK(UnweightedGraphSnapshot)
+
+#undef INSTANTIATE_PAGERANK
@@ -0,0 +1,67 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+namespace graph {
+
+    struct PageRankOptions{
+        double damping = 0.85;      // the probability to follow an edge, in [0, 1)
+        double tolerance = 1e-9;    // stop when the L1 change of the ranks in one iteration is below this
+        int maxIterations = 100;
+        ThreadPool* pool = nullptr; // null - everything runs on the calling thread
+    };
+
+    struct PageRankResult{
+        DynamicArray<double> ranks;     // ranks[v - 1], they sum to 1
+        int iterations = 0;
+        double residual = 0;            // the L1 change in the last iteration
+        bool converged = false;
+    };
+
+    /*
+    PageRank by power iteration, pulled over the transposed graph (CSR - the sources of the edges into every vertex).
+    An iteration first divides every rank by the out degree of its vertex, then every vertex sums the shares of its
+    sources - one sequential run over its part of the sources array, no writes to other vertices and no atomics.
+    The vertices are split into fixed blocks (parallel on the pool when there is one), and the residual and the rank
+    of the dangling vertices (no out edges, their rank is spread like a teleport) are summed per block and then in
+    block order, so the result is the same with any number of threads.
+    The weights are ignored, every out edge gets the same share. The engine is built once and can run many times.
+    */
+    template <typename V>
+    class PageRankEngine{
+    private:
+        V numOfVertices;
+        long long numOfEdges;
+        DynamicArray<long long> offsets;    // the sources of vertex v are sources[offsets[v - 1] .. offsets[v])
+        DynamicArray<V> sources;
+        DynamicArray<double> outShare;      // 1 / out degree, 0 for a dangling vertex
+
+        PageRankResult solve(const DynamicArray<double>& teleport, const PageRankOptions& options) const;
+
+    public:
+        template <typename G>
+        explicit PageRankEngine(G& g);
+
+        V getNumOfVertices() const;
+        long long getNumOfEdges() const;
+
+        PageRankResult pageRank(const PageRankOptions& options = PageRankOptions()) const;
+        // the teleports (and the dangling rank) go only to the seeds, a repeated seed gets a bigger share
+        PageRankResult personalizedPageRank(const DynamicArray<V>& seeds, const PageRankOptions& options = PageRankOptions()) const;
+
+    };  // class PageRankEngine
+
+    // One-off runs, the engine is built and thrown away
+    template <typename G>
+    PageRankResult pageRank(G& g, const PageRankOptions& options = PageRankOptions());
+    template <typename G>
+    PageRankResult personalizedPageRank(G& g, const DynamicArray<typename G::vertex_type>& seeds,
+                                        const PageRankOptions& options = PageRankOptions());
+
+}  // namespace graph
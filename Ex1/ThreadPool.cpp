@@ -0,0 +1,245 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include "ThreadPool.hpp"
+
+using namespace graph;
+
+// the pool and the index of the worker that runs on this thread
+static thread_local const ThreadPool* workerPool = nullptr;
+static thread_local int workerIndex = -1;
+
+//////////////////////////////////////////
+// WorkDeque
+//////////////////////////////////////////
+// Chase-Lev deque with the memory orders of Le, Pop, Cohen and Zappa Nardelli (PPoPP 2013)
+
+ThreadPool::WorkDeque::WorkDeque(){
+    top.store(0, std::memory_order_relaxed);
+    bottom.store(0, std::memory_order_relaxed);
+    for(long i = 0; i < CAPACITY; i++){
+        buffer[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool ThreadPool::WorkDeque::push(Task* task){
+    long b = bottom.load(std::memory_order_relaxed);
+    long t = top.load(std::memory_order_acquire);
+    if(b - t >= CAPACITY){
+        return false;
+    }
+    // release on the slot as well as the fence, so the task is visible to the thief that loads it
+    buffer[b & (CAPACITY - 1)].store(task, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+// the owner takes the newest task, it races with the thieves only on the last task
+ThreadPool::Task* ThreadPool::WorkDeque::pop(){
+    long b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long t = top.load(std::memory_order_relaxed);
+    if(t > b){
+        bottom.store(b + 1, std::memory_order_relaxed);    // empty
+        return nullptr;
+    }
+    Task* task = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if(t == b){
+        if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+            task = nullptr;     // a thief took it
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+// thieves take the oldest task
+ThreadPool::Task* ThreadPool::WorkDeque::steal(){
+    long t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long b = bottom.load(std::memory_order_acquire);
+    if(t >= b){
+        return nullptr;
+    }
+    Task* task = buffer[t & (CAPACITY - 1)].load(std::memory_order_acquire);
+    if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+        return nullptr;     // lost the race to another thief or to the owner
+    }
+    return task;
+}
+
+//////////////////////////////////////////
+// ThreadPool
+//////////////////////////////////////////
+
+ThreadPool::ThreadPool(int numThreads) : injected(1024){
+    if(numThreads <= 0){
+        numThreads = (int)std::thread::hardware_concurrency();
+    }
+    numWorkers = numThreads > 1 ? numThreads - 1 : 0;   // the calling thread is the last one
+    stopping.store(false);
+    wakeups.store(0);
+    sleeping.store(0);
+    deques = new WorkDeque[numWorkers > 0 ? numWorkers : 1];
+    workers = new std::thread[numWorkers > 0 ? numWorkers : 1];
+    for(int i = 0; i < numWorkers; i++){
+        workers[i] = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_all();
+    }
+    for(int i = 0; i < numWorkers; i++){
+        workers[i].join();
+    }
+    delete[] workers;
+    delete[] deques;
+}
+
+int ThreadPool::getNumThreads() const{
+    return numWorkers + 1;
+}
+
+// about 8 ranges per thread, enough slack for stealing to even out uneven ranges
+long ThreadPool::defaultGrain(long count) const{
+    long grain = count / ((long)getNumThreads() * 8);
+    return grain > 0 ? grain : 1;
+}
+
+ThreadPool& ThreadPool::shared(){
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::currentWorker() const{
+    return workerPool == this ? workerIndex : -1;
+}
+
+void ThreadPool::notify(){
+    wakeups.fetch_add(1);
+    if(sleeping.load() > 0){
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_one();
+    }
+}
+
+// false if there is no room, the caller runs the task itself
+bool ThreadPool::submit(Task* task, int self){
+    bool added = self >= 0 ? deques[self].push(task) : injected.tryEnqueue(task);
+    if(added){
+        notify();
+    }
+    return added;
+}
+
+// own deque first (the newest, cache warm work), then the submitted tasks, then a random victim
+ThreadPool::Task* ThreadPool::findTask(int self, unsigned& seed){
+    Task* task = nullptr;
+    if(self >= 0){
+        task = deques[self].pop();
+        if(task != nullptr) return task;
+    }
+    if(injected.tryDequeue(task)){
+        return task;
+    }
+    if(numWorkers == 0){
+        return nullptr;
+    }
+    seed = seed * 1103515245u + 12345u;
+    int start = (int)((seed >> 16) % (unsigned)numWorkers);
+    for(int i = 0; i < numWorkers; i++){
+        int victim = (start + i) % numWorkers;
+        if(victim == self) continue;
+        task = deques[victim].steal();
+        if(task != nullptr) return task;
+    }
+    return nullptr;
+}
+
+// split off upper halves for the other threads until the grain size, then run the rest
+void ThreadPool::execute(Task* task, int self){
+    Job* job = task->job;
+    long begin = task->begin;
+    long end = task->end;
+    delete task;
+
+    while(end - begin > job->grain){
+        long middle = begin + (end - begin) / 2;
+        Task* upper = new Task{job, middle, end};
+        if(!submit(upper, self)){
+            delete upper;
+            break;
+        }
+        end = middle;
+    }
+
+    if(!job->failed.load(std::memory_order_relaxed)){
+        try{
+            job->run(job->body, begin, end);
+        }
+        catch(...){
+            bool expected = false;
+            if(job->failed.compare_exchange_strong(expected, true)){
+                job->error = std::current_exception();
+            }
+        }
+    }
+    // the job may be gone once pending reaches 0, it is not touched after this
+    job->pending.fetch_sub(end - begin, std::memory_order_acq_rel);
+}
+
+// the caller runs its share and then helps with any task until its job is finished
+void ThreadPool::runJob(Job& job, long begin, long end){
+    if(numWorkers == 0 || end - begin <= job.grain){
+        job.run(job.body, begin, end);
+        return;
+    }
+    int self = currentWorker();
+    execute(new Task{&job, begin, end}, self);
+
+    unsigned seed = (unsigned)(self + 2) * 2654435761u;
+    while(job.pending.load(std::memory_order_acquire) > 0){
+        Task* task = findTask(self, seed);
+        if(task != nullptr){
+            execute(task, self);
+        }
+        else{
+            std::this_thread::yield();
+        }
+    }
+    if(job.failed.load()){
+        std::rethrow_exception(job.error);
+    }
+}
+
+void ThreadPool::workerLoop(int index){
+    workerPool = this;
+    workerIndex = index;
+    unsigned seed = (unsigned)(index + 1) * 2654435761u;
+    while(true){
+        unsigned seen = wakeups.load();
+        Task* task = findTask(index, seed);
+        if(task != nullptr){
+            execute(task, index);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if(stopping.load()){
+            break;
+        }
+        // sleep only if no work was added since the search started (notify() checks sleeping after adding)
+        sleeping.fetch_add(1);
+        if(wakeups.load() == seen){
+            sleepCondition.wait(lock);
+        }
+        sleeping.fetch_sub(1);
+    }
+}
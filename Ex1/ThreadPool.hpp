@@ -0,0 +1,140 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "Data_Structures.hpp"
+
+namespace graph {
+
+    /*
+    Work stealing scheduler shared by the parallel algorithms.
+    Every worker owns a Chase-Lev deque: it pushes and pops tasks at the bottom, other workers steal
+    from the top, so a busy worker never takes a lock and idle workers take the oldest (biggest) tasks.
+    parallel_for splits a range lazily - a task keeps the lower half and pushes the upper half,
+    and only stops splitting at the grain size, so the ranges adapt to how many workers are idle.
+    Use ThreadPool::shared() instead of creating pools, so parallel algorithms don't oversubscribe the machine.
+    */
+    class ThreadPool {
+    private:
+        // one parallel_for call
+        struct Job {
+            void (*run)(void* body, long begin, long end);   // calls the body on [begin, end)
+            void* body;
+            long grain;
+            std::atomic<long> pending;      // indexes not finished yet
+            std::atomic<bool> failed;
+            std::exception_ptr error;       // the first exception thrown by the body
+        };
+
+        // a sub range of a job
+        struct Task {
+            Job* job;
+            long begin;
+            long end;
+        };
+
+        // Chase-Lev deque with a fixed capacity (push fails when it is full, the task is run inline instead)
+        class WorkDeque {
+        private:
+            static constexpr long CAPACITY = 4096;
+            alignas(64) std::atomic<long> top;
+            alignas(64) std::atomic<long> bottom;
+            std::atomic<Task*> buffer[CAPACITY];
+
+        public:
+            WorkDeque();
+            bool push(Task* task);      // owner only
+            Task* pop();                // owner only
+            Task* steal();              // any thread
+        };  // class WorkDeque
+
+        int numWorkers;
+        std::thread* workers;
+        WorkDeque* deques;
+        MPMCQueue<Task*> injected;      // tasks submitted by threads that are not workers
+        std::atomic<bool> stopping;
+        std::atomic<unsigned> wakeups;  // bumped whenever work is added
+        std::atomic<int> sleeping;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+
+        void workerLoop(int index);
+        int currentWorker() const;      // the index of the calling worker, -1 for other threads
+        bool submit(Task* task, int self);
+        Task* findTask(int self, unsigned& seed);
+        void execute(Task* task, int self);
+        void runJob(Job& job, long begin, long end);
+        void notify();
+
+        template <typename F>
+        static void invokeRange(void* body, long begin, long end);
+
+    public:
+        ThreadPool(int numThreads = 0);     // 0 - one worker per hardware thread (minus the caller)
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ~ThreadPool();
+
+        int getNumThreads() const;          // workers + the calling thread
+        long defaultGrain(long count) const;
+
+        // body(begin, end) for disjoint sub ranges covering [begin, end), returns when all of them finished.
+        // grain 0 picks defaultGrain(). The calling thread works too, nested calls are allowed.
+        // The first exception thrown by the body is rethrown here (after all the sub ranges finished).
+        template <typename F>
+        void parallel_for_range(long begin, long end, F&& body, long grain = 0);
+
+        // body(i) for every i in [begin, end)
+        template <typename F>
+        void parallel_for(long begin, long end, F&& body, long grain = 0);
+
+        static ThreadPool& shared();
+
+    };  // class ThreadPool
+
+
+//////////////////////////////////////////
+// ThreadPool
+//////////////////////////////////////////
+// The templates only wrap the body into a Job, the scheduling is in ThreadPool.cpp
+
+template <typename F>
+void ThreadPool::invokeRange(void* body, long begin, long end){
+    (*static_cast<F*>(body))(begin, end);
+}
+
+template <typename F>
+void ThreadPool::parallel_for_range(long begin, long end, F&& body, long grain){
+    if(begin >= end){
+        return;
+    }
+    using Body = typename std::remove_reference<F>::type;
+    Job job;
+    job.run = &invokeRange<Body>;
+    job.body = const_cast<void*>(static_cast<const void*>(&body));
+    job.grain = grain > 0 ? grain : defaultGrain(end - begin);
+    job.failed.store(false, std::memory_order_relaxed);
+    job.pending.store(end - begin, std::memory_order_relaxed);
+    runJob(job, begin, end);
+}
+
+template <typename F>
+void ThreadPool::parallel_for(long begin, long end, F&& body, long grain){
+    auto ranged = [&body](long first, long last){
+        for(long i = first; i < last; i++){
+            body(i);
+        }
+    };
+    parallel_for_range(begin, end, ranged, grain);
+}
+
+}  // namespace graph
@@ -0,0 +1,297 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#include <stdexcept>
+#include "VersionedGraph.hpp"
+
+using namespace graph;
+
+template <typename V, typename W, typename P>
+static typename BasicGraphSnapshot<V, W, P>::edge_type makeVersionedEdge(V dest, W weight){
+    if constexpr(std::is_same<P, Unweighted>::value){
+        (void)weight;
+        return dest;
+    }
+    else{
+        return typename BasicGraphSnapshot<V, W, P>::edge_type(dest, weight);
+    }
+}
+
+//////////////////////////////////////////
+// BasicGraphSnapshot
+//////////////////////////////////////////
+template <typename V, typename W, typename P>
+BasicGraphSnapshot<V, W, P>::BasicGraphSnapshot(std::shared_ptr<const Data> data) : data(std::move(data)){}
+
+template <typename V, typename W, typename P>
+const typename BasicGraphSnapshot<V, W, P>::List* BasicGraphSnapshot<V, W, P>::list(V vertex) const{
+    if(vertex < 1 || vertex > data->numOfVertices){
+        throw std::invalid_argument("Invalid vertex.");
+    }
+    long index = (long)vertex - 1;
+    return data->chunks[index / CHUNK]->lists[index % CHUNK].get();
+}
+
+template <typename V, typename W, typename P>
+V BasicGraphSnapshot<V, W, P>::getNumOfVertices() const{
+    return data->numOfVertices;
+}
+
+template <typename V, typename W, typename P>
+long long BasicGraphSnapshot<V, W, P>::getNumOfEdges() const{
+    return data->numOfEdges;
+}
+
+template <typename V, typename W, typename P>
+uint64_t BasicGraphSnapshot<V, W, P>::getVersion() const{
+    return data->version;
+}
+
+template <typename V, typename W, typename P>
+ArrayView<typename BasicGraphSnapshot<V, W, P>::edge_type> BasicGraphSnapshot<V, W, P>::neighbors(V vertex) const{
+    const List* edges = list(vertex);
+    if(edges == nullptr){
+        return ArrayView<edge_type>(nullptr, 0);
+    }
+    return ArrayView<edge_type>(edges->edges.begin(), edges->edges.getSize());
+}
+
+template <typename V, typename W, typename P>
+int BasicGraphSnapshot<V, W, P>::degree(V vertex) const{
+    const List* edges = list(vertex);
+    return edges == nullptr ? 0 : edges->edges.getSize();
+}
+
+template <typename V, typename W, typename P>
+bool BasicGraphSnapshot<V, W, P>::hasEdge(V src, V dest) const{
+    for(const edge_type& edge : neighbors(src)){
+        if(edgeTarget(edge) == dest){
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename V, typename W, typename P>
+bool BasicGraphSnapshot<V, W, P>::hasNegativeEdge() const{
+    return data->negativeEdges > 0;
+}
+
+template <typename V, typename W, typename P>
+BasicGraph<V, W, P> BasicGraphSnapshot<V, W, P>::toGraph() const{
+    DynamicArray<Pair<Pair<V, V>, W>> edges;
+    edges.reserve((int)data->numOfEdges);
+    for(V v = 1; v <= data->numOfVertices; v++){
+        for(const edge_type& edge : neighbors(v)){
+            edges.push_back(Pair<Pair<V, V>, W>(Pair<V, V>(v, edgeTarget(edge)), edgeWeight<W>(edge)));
+        }
+    }
+    BasicGraph<V, W, P> g(data->numOfVertices);
+    g.appendUniqueEdges(edges);     // a version never holds duplicates
+    return g;
+}
+
+//////////////////////////////////////////
+// BasicVersionedGraph
+//////////////////////////////////////////
+// version 0 with n vertices and no edges, the chunks are allocated with empty lists
+template <typename V, typename W, typename P>
+std::shared_ptr<typename BasicVersionedGraph<V, W, P>::Data> BasicVersionedGraph<V, W, P>::emptyVersion(V n){
+    std::shared_ptr<Data> initial = std::make_shared<Data>();
+    initial->numOfVertices = n;
+    initial->numOfEdges = 0;
+    initial->negativeEdges = 0;
+    initial->version = 0;
+    long numChunks = ((long)n + Snapshot::CHUNK - 1) / Snapshot::CHUNK;
+    initial->chunks.reserve((int)numChunks);
+    for(long i = 0; i < numChunks; i++){
+        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+        chunk->version = 0;
+        initial->chunks.push_back(std::move(chunk));
+    }
+    return initial;
+}
+
+template <typename V, typename W, typename P>
+BasicVersionedGraph<V, W, P>::BasicVersionedGraph(V n){
+    published = emptyVersion(n);
+}
+
+template <typename V, typename W, typename P>
+BasicVersionedGraph<V, W, P>::BasicVersionedGraph(const BasicGraph<V, W, P>& g){
+    std::shared_ptr<Data> initialVersion = emptyVersion(g.getNumOfVertices());
+    Data& initial = *initialVersion;
+    for(V v = 1; v <= g.getNumOfVertices(); v++){
+        ArrayView<edge_type> edges = g.neighbors(v);
+        if(edges.isEmpty()) continue;
+        std::shared_ptr<List> list = std::make_shared<List>();
+        list->version = 0;
+        list->edges.reserve(edges.getSize());
+        for(const edge_type& edge : edges){
+            list->edges.push_back(edge);
+            if(edgeWeight<W>(edge) < W(0)) initial.negativeEdges++;
+        }
+        initial.chunks[((long)v - 1) / Snapshot::CHUNK]->lists[((long)v - 1) % Snapshot::CHUNK] = std::move(list);
+    }
+    initial.numOfEdges = g.getNumOfEdges();
+    published = std::move(initialVersion);
+}
+
+template <typename V, typename W, typename P>
+const typename BasicVersionedGraph<V, W, P>::Data& BasicVersionedGraph<V, W, P>::current() const{
+    return draft != nullptr ? *draft : *published;
+}
+
+// copies only the chunk pointers, the chunks themselves are copied on their first change
+template <typename V, typename W, typename P>
+typename BasicVersionedGraph<V, W, P>::Data& BasicVersionedGraph<V, W, P>::edit(){
+    if(draft == nullptr){
+        draft = std::make_shared<Data>(*published);
+        draft->version = published->version + 1;
+    }
+    return *draft;
+}
+
+template <typename V, typename W, typename P>
+typename BasicVersionedGraph<V, W, P>::List& BasicVersionedGraph<V, W, P>::editList(V vertex){
+    Data& data = edit();
+    long index = (long)vertex - 1;
+    std::shared_ptr<Chunk>& chunk = data.chunks[index / Snapshot::CHUNK];
+    if(chunk->version != data.version){
+        chunk = std::make_shared<Chunk>(*chunk);
+        chunk->version = data.version;
+    }
+    std::shared_ptr<List>& list = chunk->lists[index % Snapshot::CHUNK];
+    if(list == nullptr){
+        list = std::make_shared<List>();
+        list->version = data.version;
+    }
+    else if(list->version != data.version){
+        list = std::make_shared<List>(*list);
+        list->version = data.version;
+    }
+    return *list;
+}
+
+template <typename V, typename W, typename P>
+int BasicVersionedGraph<V, W, P>::findEdge(V src, V dest) const{
+    const Data& data = current();
+    long index = (long)src - 1;
+    const List* list = data.chunks[index / Snapshot::CHUNK]->lists[index % Snapshot::CHUNK].get();
+    if(list == nullptr){
+        return -1;
+    }
+    const edge_type* edges = list->edges.begin();
+    for(int i = 0; i < list->edges.getSize(); i++){
+        if(edgeTarget(edges[i]) == dest){
+            return i;
+        }
+    }
+    return -1;
+}
+
+template <typename V, typename W, typename P>
+void BasicVersionedGraph<V, W, P>::appendEdge(V src, V dest, W weight){
+    editList(src).edges.push_back(makeVersionedEdge<V, W, P>(dest, weight));
+    draft->numOfEdges++;
+    if(weight < W(0)) draft->negativeEdges++;
+}
+
+template <typename V, typename W, typename P>
+typename BasicVersionedGraph<V, W, P>::Snapshot BasicVersionedGraph<V, W, P>::snapshot() const{
+    return Snapshot(std::atomic_load(&published));
+}
+
+template <typename V, typename W, typename P>
+V BasicVersionedGraph<V, W, P>::getNumOfVertices() const{
+    return published->numOfVertices;
+}
+
+template <typename V, typename W, typename P>
+uint64_t BasicVersionedGraph<V, W, P>::getVersion() const{
+    return published->version;
+}
+
+template <typename V, typename W, typename P>
+EdgeStatus BasicVersionedGraph<V, W, P>::tryAddEdge(V src, V dest, W weight){
+    V n = getNumOfVertices();
+    if(src < 1 || src > n || dest < 1 || dest > n || src == dest){
+        return EdgeStatus::Invalid;
+    }
+    bool srcEdge = findEdge(src, dest) >= 0;
+    bool destEdge = findEdge(dest, src) >= 0;
+    if(srcEdge && destEdge){
+        return EdgeStatus::AlreadyExists;
+    }
+    if(std::is_same<P, Unweighted>::value && weight != W(1)){
+        return EdgeStatus::InvalidWeight;
+    }
+    if(!srcEdge){
+        appendEdge(src, dest, weight);
+    }
+    if(!destEdge){
+        appendEdge(dest, src, weight);
+    }
+    return srcEdge ? EdgeStatus::ForwardExisted : destEdge ? EdgeStatus::BackwardExisted : EdgeStatus::Added;
+}
+
+template <typename V, typename W, typename P>
+EdgeStatus BasicVersionedGraph<V, W, P>::tryAddDirectedEdge(V src, V dest, W weight){
+    V n = getNumOfVertices();
+    if(src < 1 || src > n || dest < 1 || dest > n || src == dest){
+        return EdgeStatus::Invalid;
+    }
+    if(findEdge(src, dest) >= 0){
+        return EdgeStatus::AlreadyExists;
+    }
+    if(std::is_same<P, Unweighted>::value && weight != W(1)){
+        return EdgeStatus::InvalidWeight;
+    }
+    appendEdge(src, dest, weight);
+    return EdgeStatus::Added;
+}
+
+// one scan of the list, the position found in the current list is the same in the draft's copy
+template <typename V, typename W, typename P>
+void BasicVersionedGraph<V, W, P>::removeEdge(V src, V dest){
+    int position = src < 1 || src > getNumOfVertices() ? -1 : findEdge(src, dest);
+    if(position < 0){
+        throw std::invalid_argument("Edge does not exist.");
+    }
+    DynamicArray<edge_type>& edges = editList(src).edges;
+    if(edgeWeight<W>(edges[position]) < W(0)) draft->negativeEdges--;
+    edges.removeAtUnordered(position);
+    draft->numOfEdges--;
+}
+
+template <typename V, typename W, typename P>
+bool BasicVersionedGraph<V, W, P>::hasPendingChanges() const{
+    return draft != nullptr;
+}
+
+// the draft is never changed again after this, a new one is started by the next change
+template <typename V, typename W, typename P>
+uint64_t BasicVersionedGraph<V, W, P>::publish(){
+    if(draft != nullptr){
+        std::shared_ptr<const Data> next = std::move(draft);
+        draft = nullptr;
+        std::atomic_store(&published, next);
+    }
+    return published->version;
+}
+
+// The same (vertex id, weight) combinations as BasicGraph
+template class graph::BasicGraphSnapshot<int, int>;
+template class graph::BasicGraphSnapshot<uint32_t, uint8_t>;
+template class graph::BasicGraphSnapshot<uint32_t, float>;
+template class graph::BasicGraphSnapshot<uint32_t, int64_t>;
+template class graph::BasicGraphSnapshot<int, int, graph::Unweighted>;
+template class graph::BasicGraphSnapshot<uint32_t, uint32_t, graph::Unweighted>;
+template class graph::BasicVersionedGraph<int, int>;
+template class graph::BasicVersionedGraph<uint32_t, uint8_t>;
+template class graph::BasicVersionedGraph<uint32_t, float>;
+template class graph::BasicVersionedGraph<uint32_t, int64_t>;
+template class graph::BasicVersionedGraph<int, int, graph::Unweighted>;
+template class graph::BasicVersionedGraph<uint32_t, uint32_t, graph::Unweighted>;
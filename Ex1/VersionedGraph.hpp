@@ -0,0 +1,126 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "Graph.hpp"
+
+namespace graph {
+
+    template <typename V, typename W, typename P>
+    class BasicVersionedGraph;
+
+    /*
+    An immutable version of a BasicVersionedGraph.
+    A snapshot is a cheap handle (one shared pointer), copies share the same version and keep it alive.
+    It offers what the algorithms need, so bfs, dijkstra, etc. run directly on it, while the writer goes on.
+    */
+    template <typename V, typename W, typename P = Weighted>
+    class BasicGraphSnapshot{
+    public:
+        using vertex_type = V;
+        using weight_type = W;
+        using policy_type = P;
+        using edge_type = typename P::template Entry<V, W>;
+
+        static const int CHUNK = 64;    // vertices per chunk
+
+        // one version of an adjacency list, shared by all the versions that didn't change it
+        struct List{
+            uint64_t version;
+            DynamicArray<edge_type> edges;
+        };
+
+        // the lists of CHUNK consecutive vertices, a null list is an empty one
+        struct Chunk{
+            uint64_t version;
+            std::shared_ptr<List> lists[CHUNK];
+        };
+
+        struct Data{
+            V numOfVertices;
+            long long numOfEdges;       // directed entries
+            long long negativeEdges;
+            uint64_t version;
+            DynamicArray<std::shared_ptr<Chunk>> chunks;
+        };
+
+    private:
+        std::shared_ptr<const Data> data;
+
+        explicit BasicGraphSnapshot(std::shared_ptr<const Data> data);
+        const List* list(V vertex) const;   // null if the vertex has no edges
+
+        friend class BasicVersionedGraph<V, W, P>;
+
+    public:
+        V getNumOfVertices() const;
+        long long getNumOfEdges() const;    // directed entries (an undirected edge counts twice)
+        uint64_t getVersion() const;
+        ArrayView<edge_type> neighbors(V vertex) const;
+        int degree(V vertex) const;
+        bool hasEdge(V src, V dest) const;
+        bool hasNegativeEdge() const;
+        BasicGraph<V, W, P> toGraph() const;    // a mutable copy of this version
+
+    };  // class BasicGraphSnapshot
+
+    /*
+    A graph with one writer and any number of readers on other threads.
+    The writer's changes go to a private draft and become visible together with publish().
+    Readers take snapshot() at any time and keep reading their version while newer ones are published.
+    Copy-on-write per vertex: a version copies only the chunks (64 list pointers) and the lists it changes,
+    all the other lists are shared with the previous versions, so publishing never copies the whole graph.
+    Only snapshot() is thread safe, all the other methods belong to the single writer thread.
+    */
+    template <typename V, typename W, typename P = Weighted>
+    class BasicVersionedGraph{
+    public:
+        using Snapshot = BasicGraphSnapshot<V, W, P>;
+        using edge_type = typename Snapshot::edge_type;
+
+    private:
+        using List = typename Snapshot::List;
+        using Chunk = typename Snapshot::Chunk;
+        using Data = typename Snapshot::Data;
+
+        std::shared_ptr<const Data> published;  // swapped with std::atomic_store, read with std::atomic_load
+        std::shared_ptr<Data> draft;            // null when there are no unpublished changes
+
+        static std::shared_ptr<Data> emptyVersion(V n);
+        const Data& current() const;    // the draft if there is one, otherwise the published version
+        Data& edit();                   // the draft, started from the published version if needed
+        List& editList(V vertex);       // the vertex's list in the draft, copied first if it is shared
+        int findEdge(V src, V dest) const;  // the position in the list of src (a copy keeps it), -1 if there is no edge
+        void appendEdge(V src, V dest, W weight);
+
+    public:
+        BasicVersionedGraph(V n);
+        explicit BasicVersionedGraph(const BasicGraph<V, W, P>& g);    // version 0 is a copy of g
+
+        BasicVersionedGraph(const BasicVersionedGraph& other) = delete;
+        BasicVersionedGraph& operator=(const BasicVersionedGraph& other) = delete;
+
+        Snapshot snapshot() const;      // the last published version, any thread
+        V getNumOfVertices() const;
+        uint64_t getVersion() const;    // of the last published version
+
+        // the writer - the same rules as the silent insertion of BasicGraph
+        EdgeStatus tryAddEdge(V src, V dest, W weight = W(1));
+        EdgeStatus tryAddDirectedEdge(V src, V dest, W weight = W(1));
+        void removeEdge(V src, V dest);     // removes the directed edge, throws if it doesn't exist
+        bool hasPendingChanges() const;
+        uint64_t publish();                 // makes the changes visible, returns the new version
+
+    };  // class BasicVersionedGraph
+
+    using GraphSnapshot = BasicGraphSnapshot<int, int>;
+    using VersionedGraph = BasicVersionedGraph<int, int>;
+    using UnweightedGraphSnapshot = BasicGraphSnapshot<int, int, Unweighted>;
+    using UnweightedVersionedGraph = BasicVersionedGraph<int, int, Unweighted>;
+
+}  // namespace graph
@@ -0,0 +1,232 @@
+/*
+author: Meir Yust
+mail: meyu251@gmail.com
+*/
+
+/*
+Benchmark of the graph construction and the algorithms on synthetic graphs from Generators.hpp
+(the weighted Graph, and the same edges as an UnweightedGraph and with 8 bit weights).
+usage: bench_exec [--vertices n] [--degree d] [--repeats r] [--seed s] [--generator gnm|rmat] [--json file]
+Every workload runs r times, the median / p90 / p99 / min / max times, the edges per second (of the median),
+the growth of the peak memory (max RSS) and the peak heap usage of one run (counted by AllocationHook.cpp)
+are printed as a table, and as JSON to the --json file if given.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include "Algorithms.hpp"
+#include "Generators.hpp"
+#include "Instrumentation.hpp"
+#include "PageRank.hpp"
+
+using namespace std;
+using namespace graph;
+
+struct Config{
+    int vertices = 20000;
+    int degree = 8;         // average undirected degree
+    int repeats = 5;
+    uint64_t seed = 42;
+    string generator = "gnm";   // gnm - uniform G(n, m), rmat - skewed degrees (n is rounded up to a power of two)
+    string jsonPath;
+};
+
+struct Result{
+    string name;
+    DynamicArray<double> samples;   // milliseconds
+    long long edges = 0;            // edges processed by one run
+    long rssGrowthKb = 0;
+    size_t heapPeakBytes = 0;       // the largest heap growth of a single run
+};
+
+// peak resident set size of the process, in KB (Linux reports ru_maxrss in KB)
+static long peakRssKb(){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/*
+The benchmark graph from the generators, with about degree * n / 2 undirected edges.
+The same seed gives the same edges for every G, only the weights differ (none for an unweighted graph)
+*/
+template <typename G>
+static G buildGraph(const Config& config, double maxWeight){
+    GeneratorOptions options;
+    options.seed = config.seed;
+    options.maxWeight = maxWeight;
+    if(config.generator == "rmat"){
+        int scale = 1;
+        while((1L << scale) < config.vertices){
+            scale++;
+        }
+        return rmat<G>(scale, max(1, config.degree / 2), options);
+    }
+    return gnm<G>(config.vertices, (long long)config.vertices * config.degree / 2, options);
+}
+
+// nearest rank percentile of sorted samples
+static double percentile(const DynamicArray<double>& sorted, double p){
+    int rank = (int)(p / 100.0 * sorted.getSize() + 0.999999);
+    if(rank < 1) rank = 1;
+    if(rank > sorted.getSize()) rank = sorted.getSize();
+    return sorted[rank - 1];
+}
+
+template <typename F>
+static Result measure(const string& name, long long edges, const Config& config, F run){
+    Result result;
+    result.name = name;
+    result.edges = edges;
+    long rssBefore = peakRssKb();
+    for(int i = 0; i < config.repeats; i++){
+        AllocationScope heap;
+        auto start = chrono::steady_clock::now();
+        run();
+        auto end = chrono::steady_clock::now();
+        result.samples.push_back(chrono::duration<double, milli>(end - start).count());
+        result.heapPeakBytes = max(result.heapPeakBytes, heap.peakBytes());
+    }
+    result.rssGrowthKb = peakRssKb() - rssBefore;
+    sort(result.samples.begin(), result.samples.end());
+    return result;
+}
+
+static void printTable(const DynamicArray<Result>& results){
+    cout << left << setw(14) << "workload" << right
+         << setw(12) << "median ms" << setw(12) << "p90 ms" << setw(12) << "p99 ms"
+         << setw(12) << "min ms" << setw(12) << "max ms" << setw(16) << "edges/s" << setw(14) << "rss +KB" << setw(14) << "heap peak KB" << endl;
+    for(const Result& r : results){
+        double median = percentile(r.samples, 50);
+        cout << left << setw(14) << r.name << right << fixed << setprecision(3)
+             << setw(12) << median << setw(12) << percentile(r.samples, 90) << setw(12) << percentile(r.samples, 99)
+             << setw(12) << r.samples[0] << setw(12) << r.samples[r.samples.getSize() - 1]
+             << setw(16) << setprecision(0) << (median > 0 ? r.edges / (median / 1000.0) : 0.0)
+             << setw(14) << r.rssGrowthKb << setw(14) << r.heapPeakBytes / 1024 << endl;
+    }
+    cout << "peak RSS: " << peakRssKb() << " KB" << endl;
+}
+
+static void writeJson(const Config& config, long long edges, const DynamicArray<Result>& results, ostream& out){
+    out << fixed << setprecision(4);
+    out << "{\n";
+    out << "  \"config\": {\"generator\": \"" << config.generator << "\", \"vertices\": " << config.vertices << ", \"degree\": " << config.degree
+        << ", \"repeats\": " << config.repeats << ", \"seed\": " << config.seed << ", \"edges\": " << edges << "},\n";
+    out << "  \"peak_rss_kb\": " << peakRssKb() << ",\n";
+    out << "  \"results\": [\n";
+    for(int i = 0; i < results.getSize(); i++){
+        const Result& r = results[i];
+        double median = percentile(r.samples, 50);
+        out << "    {\"name\": \"" << r.name << "\", \"median_ms\": " << median
+            << ", \"p90_ms\": " << percentile(r.samples, 90) << ", \"p99_ms\": " << percentile(r.samples, 99)
+            << ", \"min_ms\": " << r.samples[0] << ", \"max_ms\": " << r.samples[r.samples.getSize() - 1]
+            << ", \"edges_per_sec\": " << (median > 0 ? r.edges / (median / 1000.0) : 0.0)
+            << ", \"rss_growth_kb\": " << r.rssGrowthKb << ", \"heap_peak_bytes\": " << r.heapPeakBytes << ", \"samples_ms\": [";
+        for(int j = 0; j < r.samples.getSize(); j++){
+            out << (j > 0 ? ", " : "") << r.samples[j];
+        }
+        out << "]}" << (i + 1 < results.getSize() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static bool parseArgs(int argc, char* argv[], Config& config){
+    for(int i = 1; i < argc; i++){
+        if(i + 1 >= argc){
+            return false;
+        }
+        if(strcmp(argv[i], "--vertices") == 0) config.vertices = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--degree") == 0) config.degree = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--repeats") == 0) config.repeats = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--seed") == 0) config.seed = strtoull(argv[++i], nullptr, 10);
+        else if(strcmp(argv[i], "--generator") == 0) config.generator = argv[++i];
+        else if(strcmp(argv[i], "--json") == 0) config.jsonPath = argv[++i];
+        else return false;
+    }
+    return config.vertices > 1 && config.degree > 0 && config.repeats > 0 && (config.generator == "gnm" || config.generator == "rmat");
+}
+
+int main(int argc, char* argv[]){
+    Config config;
+    if(!parseArgs(argc, argv, config)){
+        cerr << "usage: " << argv[0] << " [--vertices n] [--degree d] [--repeats r] [--seed s] [--generator gnm|rmat] [--json file]" << endl;
+        return 1;
+    }
+
+    Graph g = buildGraph<Graph>(config, 1000000);
+    long long edges = g.getNumOfEdges();
+    cout << "graph (" << config.generator << "): " << g.getNumOfVertices() << " vertices, " << edges << " directed entries" << endl;
+
+    DynamicArray<Result> results;
+    results.push_back(measure("construction", edges, config, [&config](){
+        Graph built = buildGraph<Graph>(config, 1000000);
+        (void)built;
+    }));
+    results.push_back(measure("bfs", edges, config, [&g](){ bfs(g, 1); }));
+    results.push_back(measure("dfs", edges, config, [&g](){ dfs(g, 1); }));
+    results.push_back(measure("dijkstra", edges, config, [&g](){ dijkstra(g, 1); }));
+    results.push_back(measure("prim", edges, config, [&g](){ prim(g); }));
+    results.push_back(measure("kruskal", edges, config, [&g](){ kruskal(g); }));
+    results.push_back(measure("kruskal pool", edges, config, [&g](){ parallelKruskal(g); }));
+
+    // the same edges without weights (every weight is 1) and with 8 bit weights (at most 256 distinct values)
+    UnweightedGraph unweighted = buildGraph<UnweightedGraph>(config, 1);
+    results.push_back(measure("bfs unw", edges, config, [&unweighted](){ bfs(unweighted, 1); }));
+    results.push_back(measure("dijkstra unw", edges, config, [&unweighted](){ dijkstra(unweighted, 1); }));
+    results.push_back(measure("prim unw", edges, config, [&unweighted](){ prim(unweighted); }));
+    results.push_back(measure("kruskal unw", edges, config, [&unweighted](){ kruskal(unweighted); }));
+    using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+    GraphU8 narrow = buildGraph<GraphU8>(config, 255);
+    results.push_back(measure("dijkstra u8", edges, config, [&narrow](){ dijkstra(narrow, 1u); }));
+    results.push_back(measure("prim u8", edges, config, [&narrow](){ prim(narrow); }));
+    results.push_back(measure("kruskal u8", edges, config, [&narrow](){ kruskal(narrow); }));
+
+    // hop distances from 64 landmarks: one bfs per source against one multi-source group,
+    // the group first on the calling thread only (the same threading as the bfs calls), then on the shared pool
+    DynamicArray<int> landmarks;
+    for(int i = 0; i < 64; i++){
+        landmarks.push_back(i * (g.getNumOfVertices() / 64) + 1);
+    }
+    results.push_back(measure("bfs x64", edges * 64, config, [&g, &landmarks](){
+        for(int i = 0; i < landmarks.getSize(); i++){
+            bfs(g, landmarks[i]);
+        }
+    }));
+    ThreadPool callerOnly(1);
+    results.push_back(measure("ms-bfs x64", edges * 64, config, [&g, &landmarks, &callerOnly](){
+        multiSourceBfs(g, landmarks, callerOnly);
+    }));
+    results.push_back(measure("ms-bfs pool", edges * 64, config, [&g, &landmarks](){
+        multiSourceBfs(g, landmarks, ThreadPool::shared());
+    }));
+
+    // 20 PageRank iterations (no early stop) on one engine, on the calling thread and on the shared pool
+    PageRankEngine<int> engine(g);
+    PageRankOptions sequential;
+    sequential.tolerance = 0;
+    sequential.maxIterations = 20;
+    PageRankOptions parallel = sequential;
+    parallel.pool = &ThreadPool::shared();
+    results.push_back(measure("pagerank x20", edges * 20, config, [&engine, &sequential](){ engine.pageRank(sequential); }));
+    results.push_back(measure("pr x20 pool", edges * 20, config, [&engine, &parallel](){ engine.pageRank(parallel); }));
+
+    printTable(results);
+    if(!config.jsonPath.empty()){
+        ofstream file(config.jsonPath);
+        if(!file){
+            cerr << "Cannot open " << config.jsonPath << endl;
+            return 1;
+        }
+        writeJson(config, edges, results, file);
+        cout << "JSON written to " << config.jsonPath << endl;
+    }
+    return 0;
+}
@@ -6,11 +6,26 @@ mail: meyu251@gmail.com
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include "Graph.hpp"
+#include "CompressedGraph.hpp"
 #include "Algorithms.hpp"
+#include "ThreadPool.hpp"
+#include "GraphIO.hpp"
+#include "Generators.hpp"
+#include "Instrumentation.hpp"
+#include "VersionedGraph.hpp"
+#include "ConcurrentGraph.hpp"
+#include "ExternalMemory.hpp"
+#include "PageRank.hpp"
 #include "Data_Structures.hpp"
 
 using namespace graph;
@@ -54,6 +69,18 @@ TEST_CASE("DynamicArray tests"){
         CHECK(arr[1] == 15);
     }
 
+    SUBCASE("Unordered remove"){
+        DynamicArray<int> arr;
+        arr.push_back(5);
+        arr.push_back(10);
+        arr.push_back(15);
+        arr.removeAtUnordered(0);
+        CHECK(arr.getSize() == 2);
+        CHECK(arr[0] == 15);
+        CHECK(arr[1] == 10);
+        CHECK_THROWS_AS(arr.removeAtUnordered(2), std::out_of_range);
+    }
+
     SUBCASE("Copy constructor"){
         DynamicArray<int> arr1;
         arr1.push_back(5);
@@ -70,6 +97,41 @@ TEST_CASE("DynamicArray tests"){
         CHECK(arr2.getSize() == 2);
     }
 
+    SUBCASE("Move, reserve and emplace"){
+        DynamicArray<Pair<int, int>> arr;
+        arr.reserve(10);
+        CHECK(arr.getCapacity() == 10);
+        CHECK(arr.getSize() == 0);
+        arr.emplace_back(1, 2);
+        arr.emplace_back(3, 4);
+        CHECK(arr.getCapacity() == 10);    // no reallocation
+        CHECK(arr[1].first == 3);
+
+        arr.shrink_to_fit();
+        CHECK(arr.getCapacity() == 2);
+
+        DynamicArray<Pair<int, int>> moved(std::move(arr));
+        CHECK(moved.getSize() == 2);
+        CHECK(arr.getSize() == 0);
+        CHECK(moved[0].second == 2);
+
+        DynamicArray<Pair<int, int>> assigned;
+        assigned = std::move(moved);
+        CHECK(assigned.getSize() == 2);
+        CHECK(moved.isEmpty() == true);
+
+        // pushing an element of the array itself while it grows
+        DynamicArray<std::string> words;
+        words.push_back("first");
+        words.push_back("second");
+        words.push_back(words[0]);
+        CHECK(words[2] == "first");
+        words.removeAt(0);
+        CHECK(words[0] == "second");
+        words.clear();
+        CHECK(words.isEmpty() == true);
+    }
+
     SUBCASE("Assignment operator"){
         DynamicArray<int> arr1;
         arr1.push_back(5);
@@ -147,6 +209,58 @@ TEST_CASE("Queue tests"){
     }
 }
 
+TEST_CASE("Queue ring buffer tests"){
+    SUBCASE("Growing while wrapped keeps the order"){
+        Queue<int> q;
+        for(int i = 0; i < 3; i++){
+            q.enqueue(i);
+        }
+        q.dequeue();
+        q.dequeue();
+        for(int i = 3; i < 20; i++){    // wraps around and then grows
+            q.enqueue(i);
+        }
+        for(int i = 2; i < 20; i++){
+            CHECK(q.dequeue() == i);
+        }
+        CHECK(q.isEmpty() == true);
+    }
+
+    SUBCASE("Enqueue range and drain"){
+        DynamicArray<int> values;
+        for(int i = 0; i < 10; i++){
+            values.push_back(i);
+        }
+        Queue<int> q;
+        q.enqueue(-1);
+        q.enqueueRange(values);
+        CHECK(q.getSize() == 11);
+        CHECK(q.dequeue() == -1);
+
+        DynamicArray<int> out;
+        q.drain(out);
+        CHECK(q.isEmpty() == true);
+        CHECK(out.getSize() == 10);
+        CHECK(out[0] == 0);
+        CHECK(out[9] == 9);
+    }
+
+    SUBCASE("Copy and move"){
+        Queue<std::string> q;
+        q.enqueue("a");
+        q.enqueue("b");
+        Queue<std::string> copy(q);
+        q.dequeue();
+        CHECK(copy.getSize() == 2);
+        CHECK(copy.peek() == "a");
+
+        Queue<std::string> moved(std::move(copy));
+        CHECK(moved.dequeue() == "a");
+        CHECK(moved.dequeue() == "b");
+        CHECK(copy.isEmpty() == true);
+    }
+}
+
 TEST_CASE("Stack tests"){
     SUBCASE("Empty stack"){
         Stack<int> s;
@@ -240,6 +354,710 @@ TEST_CASE("PriorityQueue tests"){
     }
 }
 
+TEST_CASE("PriorityQueue bulk and d-ary tests"){
+    DynamicArray<int> values;
+    for(int i = 0; i < 200; i++){
+        values.push_back((i * 37) % 101);   // unsorted, with duplicates
+    }
+
+    SUBCASE("Bulk construction"){
+        PriorityQueue<int> pq(values);
+        CHECK(pq.getSize() == 200);
+        int previous = pq.dequeue();
+        while(!pq.isEmpty()){
+            int current = pq.dequeue();
+            CHECK(previous <= current);
+            previous = current;
+        }
+    }
+
+    SUBCASE("Push range into a small and a big heap"){
+        PriorityQueue<int, std::less<int>, 2> binary;
+        binary.enqueue(50);
+        binary.pushRange(values);     // more values than the heap - rebuilt
+        binary.pushRange(values);     // fewer values than the heap - pushed one by one
+        CHECK(binary.getSize() == 401);
+        CHECK(binary.peek() == 0);
+        int previous = binary.dequeue();
+        while(!binary.isEmpty()){
+            int current = binary.dequeue();
+            CHECK(previous <= current);
+            previous = current;
+        }
+    }
+
+    SUBCASE("Other arity, copy and move"){
+        PriorityQueue<Pair<int, int>, std::less<Pair<int, int>>, 8> pq;
+        for(int i = 0; i < 50; i++){
+            pq.enqueue({i, 100 - i});
+        }
+        PriorityQueue<Pair<int, int>, std::less<Pair<int, int>>, 8> copy(pq);
+        PriorityQueue<Pair<int, int>, std::less<Pair<int, int>>, 8> moved(std::move(pq));
+        CHECK(pq.isEmpty() == true);
+        CHECK(copy.dequeue().second == 51);
+        CHECK(moved.dequeue().first == 49);
+        CHECK(moved.getSize() == 49);
+    }
+}
+
+// squares the value, used as a key extractor
+struct SquareKey{
+    int operator()(int x) const { return x * x; }
+};
+
+// a comparator with state - orders by the distance from a pivot
+struct ClosestTo{
+    int pivot;
+    bool operator()(int a, int b) const { return std::abs(a - pivot) < std::abs(b - pivot); }
+};
+
+TEST_CASE("PriorityQueue comparator tests"){
+    SUBCASE("Max-heap with Reverse"){
+        PriorityQueue<int, Reverse<std::less<int>>> pq;
+        for(int x : {5, 1, 9, 3, 7}){
+            pq.enqueue(x);
+        }
+        CHECK(pq.dequeue() == 9);
+        CHECK(pq.dequeue() == 7);
+        CHECK(pq.dequeue() == 5);
+
+        PriorityQueue<int, std::greater<int>> greater;
+        greater.enqueue(2);
+        greater.enqueue(8);
+        CHECK(greater.peek() == 8);
+    }
+
+    SUBCASE("Pair comparators and tie breaking"){
+        DynamicArray<Pair<int, int>> values;
+        values.push_back({3, 10});
+        values.push_back({1, 10});
+        values.push_back({2, 5});
+        values.push_back({4, 10});
+
+        PriorityQueue<Pair<int, int>, LessBySecondThenFirst> bySecond(values);
+        CHECK(bySecond.dequeue().first == 2);
+        CHECK(bySecond.dequeue().first == 1);
+        CHECK(bySecond.dequeue().first == 3);
+        CHECK(bySecond.dequeue().first == 4);
+
+        PriorityQueue<Pair<int, int>, LessByFirst> byFirst(values);
+        CHECK(byFirst.dequeue().first == 1);
+        CHECK(byFirst.dequeue().first == 2);
+
+        CHECK(LessBySecond()(Pair<int, int>(9, 1), Pair<int, int>(1, 2)) == true);
+    }
+
+    SUBCASE("Key extractor"){
+        PriorityQueue<int, KeyCompare<SquareKey>> pq;
+        for(int x : {-5, 2, -1, 4}){
+            pq.enqueue(x);
+        }
+        CHECK(pq.dequeue() == -1);
+        CHECK(pq.dequeue() == 2);
+        CHECK(pq.dequeue() == 4);
+        CHECK(pq.dequeue() == -5);
+    }
+
+    SUBCASE("Stateful comparator survives copy and move"){
+        PriorityQueue<int, ClosestTo> pq(ClosestTo{50});
+        for(int x : {10, 45, 90, 53}){
+            pq.enqueue(x);
+        }
+        PriorityQueue<int, ClosestTo> copy(pq);
+        PriorityQueue<int, ClosestTo> moved(std::move(pq));
+        CHECK(copy.dequeue() == 53);
+        CHECK(copy.dequeue() == 45);
+        CHECK(moved.dequeue() == 53);
+
+        PriorityQueue<int, ClosestTo> assigned(ClosestTo{0});
+        assigned = copy;
+        assigned.enqueue(60);
+        CHECK(assigned.dequeue() == 60);
+    }
+
+    SUBCASE("Stateless comparators take no space"){
+        CHECK(sizeof(PriorityQueue<int, std::less<int>>) == sizeof(PriorityQueue<int, std::greater<int>>));
+        CHECK(sizeof(PriorityQueue<int, ClosestTo>) > sizeof(PriorityQueue<int>));
+    }
+}
+
+TEST_CASE("MPMCQueue tests"){
+    SUBCASE("Single thread, bounded"){
+        MPMCQueue<int> q(5);
+        CHECK(q.getCapacity() == 8);
+        CHECK(q.isEmpty() == true);
+        for(int i = 0; i < 8; i++){
+            CHECK(q.tryEnqueue(i) == true);
+        }
+        CHECK(q.tryEnqueue(100) == false);
+        CHECK(q.approxSize() == 8);
+        int value = -1;
+        CHECK(q.tryDequeue(value) == true);
+        CHECK(value == 0);
+        CHECK(q.tryEnqueue(8) == true);    // the freed slot is reused on the next round
+        for(int i = 1; i <= 8; i++){
+            CHECK(q.dequeue() == i);
+        }
+        CHECK(q.tryDequeue(value) == false);
+    }
+
+    SUBCASE("Many producers and many consumers"){
+        const int producers = 4;
+        const int consumers = 4;
+        const int perProducer = 5000;
+        MPMCQueue<int> q(64);
+        std::atomic<long long> sum(0);
+        std::atomic<int> received(0);
+        std::thread threads[producers + consumers];
+        for(int p = 0; p < producers; p++){
+            threads[p] = std::thread([&q, p, perProducer](){
+                for(int i = 1; i <= perProducer; i++){
+                    q.enqueue(p * perProducer + i);
+                }
+            });
+        }
+        for(int c = 0; c < consumers; c++){
+            threads[producers + c] = std::thread([&](){
+                int value;
+                while(received.load() < producers * perProducer){
+                    if(q.tryDequeue(value)){
+                        sum += value;
+                        received++;
+                    }
+                    else{
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for(std::thread& t : threads){
+            t.join();
+        }
+        long long n = (long long)producers * perProducer;
+        CHECK(received.load() == n);
+        CHECK(sum.load() == n * (n + 1) / 2);
+        CHECK(q.isEmpty() == true);
+    }
+
+    SUBCASE("Parallel ingestion into a Graph"){
+        // the readers produce edges, a single thread owns the graph and inserts them
+        MPMCQueue<Pair<int, int>> edges(16);
+        Graph g(100);
+        std::thread readers[2];
+        for(int r = 0; r < 2; r++){
+            readers[r] = std::thread([&edges, r](){
+                for(int v = 1 + r; v < 100; v += 2){
+                    edges.enqueue(Pair<int, int>(v, v + 1));
+                }
+            });
+        }
+        for(int i = 0; i < 99; i++){
+            Pair<int, int> edge = edges.dequeue();
+            g.addDirectedEdge(edge.first, edge.second, 1);
+        }
+        for(std::thread& t : readers){
+            t.join();
+        }
+        for(int v = 1; v < 100; v++){
+            CHECK(g.hasEdge(v, v + 1) == true);
+        }
+    }
+}
+
+TEST_CASE("ThreadPool tests"){
+    ThreadPool pool(4);
+    CHECK(pool.getNumThreads() == 4);
+
+    SUBCASE("parallel_for visits every index once"){
+        const int n = 100000;
+        DynamicArray<int> hits(n);
+        for(int i = 0; i < n; i++){
+            hits.push_back(0);
+        }
+        pool.parallel_for(0, n, [&hits](long i){
+            hits[i]++;
+        });
+        bool allOnce = true;
+        for(int i = 0; i < n; i++){
+            if(hits[i] != 1) allOnce = false;
+        }
+        CHECK(allOnce == true);
+    }
+
+    SUBCASE("Ranges respect the grain and cover the range"){
+        std::atomic<long> total(0);
+        std::atomic<long> biggest(0);
+        pool.parallel_for_range(10, 1010, [&](long begin, long end){
+            total += end - begin;
+            long size = end - begin;
+            long seen = biggest.load();
+            while(size > seen && !biggest.compare_exchange_weak(seen, size)){}
+        }, 100);
+        CHECK(total.load() == 1000);
+        CHECK(biggest.load() <= 100);
+    }
+
+    SUBCASE("Nested parallel_for and uneven work"){
+        std::atomic<long> sum(0);
+        pool.parallel_for(0, 64, [&](long i){
+            pool.parallel_for(0, i, [&](long j){
+                sum += j;
+            });
+        });
+        long expected = 0;
+        for(long i = 0; i < 64; i++){
+            expected += i * (i - 1) / 2;
+        }
+        CHECK(sum.load() == expected);
+    }
+
+    SUBCASE("Exceptions reach the caller"){
+        CHECK_THROWS_AS(pool.parallel_for(0, 1000, [](long i){
+            if(i == 500) throw std::runtime_error("failed");
+        }), std::runtime_error);
+        // the pool is still usable
+        std::atomic<int> count(0);
+        pool.parallel_for(0, 100, [&count](long){ count++; });
+        CHECK(count.load() == 100);
+    }
+
+    SUBCASE("Single thread pool runs inline"){
+        ThreadPool single(1);
+        CHECK(single.getNumThreads() == 1);
+        long sum = 0;
+        single.parallel_for(0, 100, [&sum](long i){ sum += i; });
+        CHECK(sum == 4950);
+    }
+}
+
+TEST_CASE("Batch algorithms"){
+    Graph g(6);
+    g.addEdge(1, 2, 7);
+    g.addEdge(1, 3, 2);
+    g.addEdge(3, 2, 3);
+    g.addEdge(2, 4, 1);
+    g.addEdge(4, 5, 4);
+    g.addEdge(5, 6, 2);
+    ThreadPool pool(3);
+    DynamicArray<int> sources;
+    for(int v = 1; v <= 6; v++){
+        sources.push_back(v);
+    }
+
+    SUBCASE("Every tree matches the single source result"){
+        DynamicArray<Graph> dijkstraTrees = dijkstraBatch(g, sources, pool);
+        DynamicArray<Graph> bfsTrees = bfsBatch(g, sources, pool);
+        REQUIRE(dijkstraTrees.getSize() == 6);
+        REQUIRE(bfsTrees.getSize() == 6);
+        for(int i = 0; i < 6; i++){
+            Graph single = dijkstra(g, sources[i]);
+            Graph singleBfs = bfs(g, sources[i]);
+            for(int u = 1; u <= 6; u++){
+                for(int v = 1; v <= 6; v++){
+                    CHECK(dijkstraTrees[i].hasEdge(u, v) == single.hasEdge(u, v));
+                    CHECK(bfsTrees[i].hasEdge(u, v) == singleBfs.hasEdge(u, v));
+                }
+            }
+        }
+        CHECK(dijkstraTrees[0].hasEdge(3, 2) == true);     // 1 -> 3 -> 2 is shorter than 1 -> 2
+    }
+
+    SUBCASE("Invalid input is rejected before any work"){
+        sources.push_back(7);
+        CHECK_THROWS_AS(dijkstraBatch(g, sources, pool), std::invalid_argument);
+        Graph negative(2);
+        negative.addEdge(1, 2, -1);
+        DynamicArray<int> one;
+        one.push_back(1);
+        CHECK_THROWS_AS(dijkstraBatch(negative, one, pool), std::invalid_argument);
+        CHECK(bfsBatch(negative, one, pool).getSize() == 1);
+    }
+}
+
+// hop distances from one source with a plain queue, the reference for multiSourceBfs
+template <typename G>
+static DynamicArray<int> hopLevels(G& g, int source){
+    DynamicArray<int> levels;
+    for(int v = 1; v <= (int)g.getNumOfVertices(); v++){
+        levels.push_back(-1);
+    }
+    Queue<int> q;
+    q.enqueue(source);
+    levels[source - 1] = 0;
+    while(!q.isEmpty()){
+        int current = q.dequeue();
+        for(const auto& edge : g.neighbors(current)){
+            int neighbor = (int)edgeTarget(edge);
+            if(levels[neighbor - 1] == -1){
+                levels[neighbor - 1] = levels[current - 1] + 1;
+                q.enqueue(neighbor);
+            }
+        }
+    }
+    return levels;
+}
+
+TEST_CASE("Multi-source BFS"){
+    ThreadPool pool(3);
+
+    SUBCASE("Small graph with an unreachable vertex"){
+        Graph g(6);
+        g.addEdge(1, 2, 5);
+        g.addEdge(2, 3, 5);
+        g.addEdge(3, 4, 5);
+        g.addEdge(1, 4, 5);
+        g.addDirectedEdge(4, 5, 5);     // 5 can't go back
+        DynamicArray<int> sources;
+        sources.push_back(1);
+        sources.push_back(5);
+        sources.push_back(1);           // duplicates are allowed
+        DynamicArray<DynamicArray<int>> levels = multiSourceBfs(g, sources, pool);
+        REQUIRE(levels.getSize() == 3);
+        CHECK(levels[0][0] == 0);
+        CHECK(levels[0][1] == 1);
+        CHECK(levels[0][2] == 2);
+        CHECK(levels[0][3] == 1);
+        CHECK(levels[0][4] == 2);
+        CHECK(levels[0][5] == -1);
+        CHECK(levels[1][4] == 0);
+        CHECK(levels[1][0] == -1);
+        for(int v = 0; v < 6; v++){
+            CHECK(levels[2][v] == levels[0][v]);
+        }
+    }
+
+    SUBCASE("Matches single source BFS across groups"){
+        GeneratorOptions options;
+        options.seed = 11;
+        options.directed = true;
+        Graph g = gnp(300, 0.01, options);
+        DynamicArray<int> sources;
+        for(int v = 1; v <= 300; v++){
+            sources.push_back(v);
+        }
+        DynamicArray<DynamicArray<int>> narrow = multiSourceBfs(g, sources, pool);
+        DynamicArray<DynamicArray<int>> wide = multiSourceBfs<Graph, 4>(g, sources, pool);
+        CompressedGraph compressed(g);
+        DynamicArray<DynamicArray<int>> fromCompressed = multiSourceBfs(compressed, sources, pool);
+        REQUIRE(narrow.getSize() == 300);
+        REQUIRE(wide.getSize() == 300);
+        int mismatches = 0;
+        for(int i = 0; i < 300; i++){
+            DynamicArray<int> expected = hopLevels(g, sources[i]);
+            for(int v = 0; v < 300; v++){
+                if(narrow[i][v] != expected[v] || wide[i][v] != expected[v] || fromCompressed[i][v] != expected[v]){
+                    mismatches++;
+                }
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+
+    SUBCASE("Invalid sources and empty input"){
+        Graph g(3);
+        DynamicArray<int> sources;
+        CHECK(multiSourceBfs(g, sources, pool).getSize() == 0);
+        sources.push_back(4);
+        CHECK_THROWS_AS(multiSourceBfs(g, sources, pool), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Early-exit traversals"){
+    Graph g(7);
+    g.addEdge(1, 2, 1);
+    g.addEdge(2, 3, 1);
+    g.addEdge(3, 4, 1);
+    g.addEdge(4, 5, 1);
+    g.addEdge(1, 6, 1);     // 7 is isolated
+
+    SUBCASE("k-hop neighborhood"){
+        DynamicArray<Pair<int, int>> twoHops = kHopNeighborhood(g, 1, 2);
+        REQUIRE(twoHops.getSize() == 3);
+        CHECK(twoHops[0].first == 2);
+        CHECK(twoHops[0].second == 1);
+        CHECK(twoHops[1].first == 6);
+        CHECK(twoHops[1].second == 1);
+        CHECK(twoHops[2].first == 3);
+        CHECK(twoHops[2].second == 2);
+        CHECK(kHopNeighborhood(g, 1, 0).getSize() == 0);
+        CHECK(kHopNeighborhood(g, 1, 100).getSize() == 5);
+        CHECK(kHopNeighborhood(g, 7, 3).getSize() == 0);
+        CHECK_THROWS_AS(kHopNeighborhood(g, 1, -1), std::invalid_argument);
+        CHECK_THROWS_AS(kHopNeighborhood(g, 8, 1), std::invalid_argument);
+
+        CompressedGraph compressed(g);
+        CHECK(kHopNeighborhood(compressed, 3, 1).getSize() == 2);
+    }
+
+    SUBCASE("Reachability"){
+        CHECK(isReachable(g, 1, 5) == true);
+        CHECK(isReachable(g, 1, 7) == false);
+        CHECK(isReachable(g, 1, 5, 3) == false);
+        CHECK(isReachable(g, 1, 5, 4) == true);
+        CHECK(isReachable(g, 3, 3, 0) == true);
+        CHECK_THROWS_AS(isReachable(g, 1, 9), std::invalid_argument);
+
+        Graph directed(3);
+        directed.addDirectedEdge(1, 2, 1);
+        directed.addDirectedEdge(2, 3, 1);
+        CHECK(isReachable(directed, 1, 3) == true);
+        CHECK(isReachable(directed, 3, 1) == false);
+    }
+
+    SUBCASE("Visitors can stop the traversal"){
+        int visited = 0;
+        bool finished = bfsVisit(g, 1, [&visited](int, int){
+            visited++;
+            return visited < 3;
+        });
+        CHECK(finished == false);
+        CHECK(visited == 3);
+
+        DynamicArray<int> depths;
+        for(int v = 0; v < 7; v++){
+            depths.push_back(-1);
+        }
+        auto record = [&depths](int vertex, int depth){
+            depths[vertex - 1] = depth;
+            return true;
+        };
+        CHECK(bfsVisit(g, 1, record) == true);
+        CHECK(depths[0] == 0);
+        CHECK(depths[4] == 4);
+        CHECK(depths[5] == 1);
+        CHECK(depths[6] == -1);
+        CHECK(bfsVisit(g, 4, record, 1) == true);
+        CHECK(depths[3] == 0);
+        CHECK(depths[2] == 1);
+        CHECK(depths[0] == 0);      // out of reach, kept from the first run
+    }
+
+    SUBCASE("The scratch is reused without clearing"){
+        TraversalScratch<int> scratch;
+        int wrong = 0;
+        for(int i = 0; i < 1000; i++){
+            int source = i % 7 + 1;
+            if(kHopNeighborhood(g, source, 1, scratch).getSize() != g.degree(source)){
+                wrong++;
+            }
+        }
+        CHECK(wrong == 0);
+        CHECK(scratch.visited.getSize() == 7);
+
+        VisitedSet<uint8_t> small;
+        wrong = 0;
+        for(int pass = 0; pass < 600; pass++){     // the 8 bit epoch wraps around twice
+            small.reset(4);
+            if(small.isVisited(pass % 4) || !small.visit(pass % 4) || small.visit(pass % 4)){
+                wrong++;
+            }
+        }
+        CHECK(wrong == 0);
+        small.reset(10);
+        CHECK(small.getSize() == 10);
+        CHECK(small.isVisited(9) == false);
+    }
+}
+
+TEST_CASE("Algorithm instrumentation"){
+    Graph g(5);
+    g.addEdge(1, 2, 10);
+    g.addEdge(1, 3, 5);
+    g.addEdge(2, 3, 2);
+    g.addEdge(2, 4, 1);
+    g.addEdge(3, 4, 9);
+    g.addEdge(3, 5, 2);
+    g.addEdge(4, 5, 4);
+    AlgorithmStats stats;
+
+    SUBCASE("The results are the same as without counters"){
+        Graph plainBfs = bfs(g, 1);
+        Graph plainDfs = dfs(g, 1);
+        Graph plainDijkstra = dijkstra(g, 1);
+        Graph plainPrim = prim(g);
+        Graph plainKruskal = kruskal(g);
+        Graph countedBfs = bfs(g, 1, stats);
+        Graph countedDfs = dfs(g, 1, stats);
+        Graph countedDijkstra = dijkstra(g, 1, stats);
+        Graph countedPrim = prim(g, stats);
+        Graph countedKruskal = kruskal(g, stats);
+        for(int u = 1; u <= 5; u++){
+            for(int v = 1; v <= 5; v++){
+                CHECK(countedBfs.hasEdge(u, v) == plainBfs.hasEdge(u, v));
+                CHECK(countedDfs.hasEdge(u, v) == plainDfs.hasEdge(u, v));
+                CHECK(countedDijkstra.hasEdge(u, v) == plainDijkstra.hasEdge(u, v));
+                CHECK(countedPrim.hasEdge(u, v) == plainPrim.hasEdge(u, v));
+                CHECK(countedKruskal.hasEdge(u, v) == plainKruskal.hasEdge(u, v));
+            }
+        }
+        CHECK_THROWS_AS(bfs(g, 6, stats), std::invalid_argument);
+    }
+
+    SUBCASE("Dijkstra and Prim counters"){
+        dijkstra(g, 1, stats);
+        CHECK(stats.edgesScanned == 14);    // every vertex is finished once, 14 directed entries
+        CHECK(stats.heapPops == stats.heapPushes);
+        CHECK(stats.heapPops - stats.stalePops == 5);
+        CHECK(stats.relaxations == stats.heapPushes - 1);
+        CHECK(stats.allocations > 0);
+        CHECK(stats.findCalls == 0);
+
+        stats.reset();
+        CHECK(stats.edgesScanned == 0);
+        CHECK(stats.getPhases().getSize() == 0);
+        prim(g, stats);
+        CHECK(stats.edgesScanned == 14);
+        CHECK(stats.heapPops - stats.stalePops == 5);
+        CHECK(stats.relaxations == stats.heapPushes - 1);
+
+        CompressedGraph compressed(g);
+        AlgorithmStats compressedStats;
+        dijkstra(compressed, 1, compressedStats);
+        CHECK(compressedStats.edgesScanned == 14);
+    }
+
+    SUBCASE("BFS and Kruskal counters"){
+        bfs(g, 1, stats);
+        CHECK(stats.edgesScanned == 14);
+        CHECK(stats.heapPushes == 0);
+        stats.reset();
+        kruskal(g, stats);
+        CHECK(stats.edgesScanned == 14);
+        CHECK(stats.findCalls == 14);       // two finds for each of the 7 edges
+        CHECK(stats.unionCalls == 4);       // n - 1 edges in the tree
+    }
+
+    SUBCASE("Phases and Chrome trace"){
+        dijkstra(g, 1, stats);
+        kruskal(g, stats);
+        const DynamicArray<AlgorithmStats::Phase>& phases = stats.getPhases();
+        REQUIRE(phases.getSize() == 6);
+        CHECK(std::string(phases[0].name) == "init");
+        CHECK(std::string(phases[2].name) == "build tree");
+        CHECK(std::string(phases[4].name) == "sort");
+        for(int i = 0; i < phases.getSize(); i++){
+            CHECK(phases[i].durationUs >= 0);
+            if(i > 0){
+                CHECK(phases[i].startUs >= phases[i - 1].startUs);
+            }
+        }
+        CHECK(stats.phaseTotalUs("sort") == phases[4].durationUs);
+
+        std::stringstream trace;
+        stats.writeChromeTrace(trace);
+        std::string json = trace.str();
+        CHECK(json.find("\"traceEvents\"") != std::string::npos);
+        CHECK(json.find("\"name\": \"search\", \"cat\": \"algorithm\", \"ph\": \"X\"") != std::string::npos);
+        CHECK(json.find("\"edgesScanned\": 28") != std::string::npos);
+        CHECK(json.back() == '\n');
+    }
+}
+
+TEST_CASE("Memory accounting"){
+    SUBCASE("Data structures"){
+        DynamicArray<int> arr;
+        CHECK(arr.memoryUsage().reserved == 0);
+        arr.reserve(100);
+        for(int i = 0; i < 10; i++){
+            arr.push_back(i);
+        }
+        CHECK(arr.memoryUsage().used == 10 * sizeof(int));
+        CHECK(arr.memoryUsage().reserved == 100 * sizeof(int));
+        CHECK(arr.memoryUsage().slack() == 90 * sizeof(int));
+        arr.shrink_to_fit();
+        CHECK(arr.memoryUsage().slack() == 0);
+
+        PriorityQueue<int> pq;
+        CHECK(pq.memoryUsage().reserved == 0);
+        pq.enqueue(5);
+        pq.enqueue(3);
+        CHECK(pq.memoryUsage().used == 2 * sizeof(int));
+        CHECK(pq.memoryUsage().reserved >= 16 * sizeof(int));
+
+        DisjointSet<int> ds(10);
+        CHECK(ds.memoryUsage().used == 10 * sizeof(int) + 10 * sizeof(int));
+        CHECK(ds.memoryUsage().reserved >= ds.memoryUsage().used);
+
+        MemoryUsage total = arr.memoryUsage();
+        total += ds.memoryUsage();
+        CHECK(total.used == arr.memoryUsage().used + ds.memoryUsage().used);
+    }
+
+    SUBCASE("Graph slack and shrinkToFit"){
+        Graph g(3000);
+        for(int v = 1; v <= 3000; v++){
+            for(int k = 1; k <= 5; k++){
+                g.addEdge(v, (v + k * 7) % 3000 + 1, k);
+            }
+        }
+        MemoryUsage before = g.memoryUsage();
+        size_t perVertex = sizeof(ArenaList<Pair<int, int>>) + sizeof(int);
+        CHECK(before.used == perVertex * 3000 + sizeof(Pair<int, int>) * g.getNumOfEdges());
+        CHECK(before.reserved > before.used);
+
+        long long edges = g.getNumOfEdges();
+        int degree = g.degree(1);
+        g.shrinkToFit();
+        MemoryUsage after = g.memoryUsage();
+        CHECK(after.used == before.used);
+        CHECK(after.reserved < before.reserved);
+        CHECK(g.getNumOfEdges() == edges);
+        CHECK(g.hasEdge(1, 9) == true);
+        CHECK(g.degree(1) == degree);
+        g.addEdge(1, 2000, 4);      // still usable after the repack
+        CHECK(g.hasEdge(2000, 1) == true);
+
+        Graph empty(100);
+        empty.addEdge(1, 2, 3);
+        empty.removeEdge(1, 2);
+        empty.removeEdge(2, 1);
+        empty.shrinkToFit();
+        CHECK(empty.memoryUsage().reserved == perVertex * 100);     // no slab for 0 edges
+
+        CompressedGraph compressed(g);
+        MemoryUsage compressedUsage = compressed.memoryUsage();
+        CHECK(compressedUsage.used == sizeof(long long) * 3001 + sizeof(int) * 3000 + (size_t)compressed.getCompressedSize());
+        CHECK(compressedUsage.slack() == 0);
+    }
+
+    SUBCASE("Allocation scopes"){
+        REQUIRE(AllocationScope::enabled() == true);   // the tests link AllocationHook.cpp
+        size_t outerPeak;
+        size_t innerPeak;
+        long long outerCurrent;
+        long long allocations;
+        {
+            AllocationScope outer;
+            {
+                AllocationScope inner;
+                int* block = new int[1000];
+                block[0] = 1;
+                delete[] block;
+                innerPeak = inner.peakBytes();
+                allocations = inner.allocations();
+            }
+            outerPeak = outer.peakBytes();
+            outerCurrent = outer.currentBytes();
+        }
+        CHECK(innerPeak >= 1000 * sizeof(int));
+        CHECK(outerPeak >= innerPeak);
+        CHECK(outerCurrent == 0);
+        CHECK(allocations >= 1);
+
+        Graph g(200);
+        for(int v = 1; v < 200; v++){
+            g.addEdge(v, v + 1, v);
+        }
+        size_t dijkstraPeak;
+        {
+            AllocationScope scope;
+            Graph tree = dijkstra(g, 1);
+            dijkstraPeak = scope.peakBytes();
+        }
+        CHECK(dijkstraPeak >= 200 * sizeof(long long));    // at least the distances
+    }
+}
+
 TEST_CASE("DisjointSet tests"){
     SUBCASE("Basic operations"){
         DisjointSet<int> ds(5);
@@ -270,6 +1088,37 @@ TEST_CASE("DisjointSet tests"){
     }
 }
 
+TEST_CASE("SlabArena and ArenaList tests"){
+    SUBCASE("Lists share the arena and grow"){
+        SlabArena<int> arena;
+        ArenaList<int> a;
+        ArenaList<int> b;
+        for(int i = 0; i < 100; i++){
+            a.push_back(i, arena);
+            b.push_back(-i, arena);
+        }
+        CHECK(a.getSize() == 100);
+        CHECK(b.getSize() == 100);
+        CHECK(a.get(99) == 99);
+        CHECK(b.get(50) == -50);
+        CHECK(arena.getReservedBytes() > 0);
+        CHECK_THROWS_AS(a.get(100), std::out_of_range);
+
+        a.removeAt(0);
+        CHECK(a.get(0) == 1);
+        CHECK(a.getSize() == 99);
+    }
+
+    SUBCASE("Released blocks are reused"){
+        SlabArena<int> arena;
+        int* first = arena.allocate(8);
+        arena.release(first, 8);
+        int* second = arena.allocate(5);    // rounded up to 8
+        CHECK(first == second);
+        CHECK(SlabArena<int>::blockSize(5) == 8);
+    }
+}
+
 TEST_CASE("Graph tests"){
     SUBCASE("Empty graph"){
         Graph g(0);
@@ -321,6 +1170,75 @@ TEST_CASE("Graph tests"){
         CHECK(g.hasEdge(2, 1) == true);
     }
 
+    SUBCASE("Copy and assignment are deep"){
+        Graph g(4);
+        g.addEdge(1, 2, 3);
+        g.addEdge(2, 3, 4);
+
+        Graph copy(g);
+        Graph assigned(1);
+        assigned = g;
+        g.addEdge(3, 4, 5);
+        g.removeEdge(1, 2);
+
+        CHECK(copy.hasEdge(1, 2) == true);
+        CHECK(copy.hasEdge(3, 4) == false);
+        CHECK(assigned.hasEdge(1, 2) == true);
+        CHECK(assigned.getNumOfVertices() == 4);
+        CHECK(assigned.getNeighbors(3)[0].second == 4);
+    }
+
+    SUBCASE("Move keeps the lists"){
+        Graph g(3);
+        g.addEdge(1, 2, 7);
+        Graph moved(std::move(g));
+        CHECK(moved.hasEdge(2, 1) == true);
+        CHECK(g.getNumOfVertices() == 0);
+
+        Graph assigned(1);
+        assigned = std::move(moved);
+        CHECK(assigned.getNeighbors(1)[0].second == 7);
+
+        CompressedGraph cg(assigned);
+        CompressedGraph movedCg(std::move(cg));
+        CHECK(movedCg.hasEdge(1, 2) == true);
+        CHECK(cg.getCompressedSize() == 0);
+    }
+
+    SUBCASE("Batch edge removal"){
+        Graph g(5);
+        g.addEdge(1, 2, 1);
+        g.addEdge(1, 3, 2);
+        g.addEdge(1, 4, 3);
+        g.addEdge(1, 5, 4);
+        g.addEdge(2, 3, 5);
+
+        DynamicArray<Pair<int, int>> batch;
+        batch.push_back({1, 3});
+        batch.push_back({1, 5});
+        batch.push_back({2, 3});
+        batch.push_back({1, 3});    // already removed - skipped
+        batch.push_back({4, 5});    // doesn't exist - skipped
+        CHECK(g.removeEdges(batch) == 3);
+
+        // the remaining neighbors keep their order
+        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(1);
+        CHECK(neighbors.getSize() == 2);
+        CHECK(neighbors[0].first == 2);
+        CHECK(neighbors[1].first == 4);
+        CHECK(g.hasEdge(2, 3) == false);
+        CHECK(g.hasEdge(3, 2) == true);
+
+        batch.push_back({0, 1});
+        CHECK_THROWS_AS(g.removeEdges(batch), std::invalid_argument);
+        CHECK(g.hasEdge(1, 2) == true);     // nothing was removed
+
+        // single removal moves the last neighbor into the hole
+        g.removeEdge(1, 2);
+        CHECK(g.getNeighbors(1).getSize() == 1);
+        CHECK(g.getNeighbors(1)[0].first == 4);
+    }
+
     SUBCASE("Adding duplicate edges"){
         Graph g(3);
         g.addEdge(1, 2, 5);
@@ -331,6 +1249,58 @@ TEST_CASE("Graph tests"){
         CHECK_THROWS_AS(g.addDirectedEdge(2, 3, 8), std::invalid_argument);
     }
 
+    SUBCASE("Silent insertion and load report"){
+        Graph g(4);
+        std::stringstream buffer;
+        {
+            CoutRedirect redirect(buffer);
+            g.addDirectedEdge(1, 2, 3);
+            CHECK(g.tryAddEdge(1, 2, 3) == EdgeStatus::ForwardExisted);
+            g.addDirectedEdge(4, 3, 1);
+            CHECK(g.tryAddEdge(3, 4, 1) == EdgeStatus::BackwardExisted);
+            CHECK(g.tryAddEdge(1, 2, 3) == EdgeStatus::AlreadyExists);
+            CHECK(g.tryAddEdge(1, 1, 3) == EdgeStatus::Invalid);
+            CHECK(g.tryAddDirectedEdge(2, 3) == EdgeStatus::Added);
+            CHECK(g.tryAddDirectedEdge(2, 3) == EdgeStatus::AlreadyExists);
+            CHECK(g.tryAddDirectedEdge(0, 3) == EdgeStatus::Invalid);
+
+            DynamicArray<Pair<Pair<int, int>, int>> edges;
+            edges.push_back({{1, 3}, 2});   // new
+            edges.push_back({{3, 2}, 2});   // 2->3 exists
+            edges.push_back({{1, 3}, 2});   // duplicate
+            edges.push_back({{1, 9}, 2});   // invalid
+            LoadReport report = g.loadEdges(edges);
+            CHECK(report.added == 1);
+            CHECK(report.completed == 1);
+            CHECK(report.duplicates == 1);
+            CHECK(report.invalid == 1);
+            CHECK(report.total() == 4);
+
+            LoadReport directed = g.loadEdges(edges, true);
+            CHECK(directed.duplicates == 3);
+            CHECK(directed.invalid == 1);
+        }
+        CHECK(buffer.str().empty());    // nothing was printed
+        CHECK(g.hasEdge(2, 1) == true);
+        CHECK(g.hasEdge(3, 2) == true);
+        CHECK(g.getNumOfEdges() == 8);
+
+        DynamicArray<Pair<Pair<int, int>, int>> unique;
+        unique.push_back({{4, 1}, 6});
+        unique.push_back({{4, 2}, 6});
+        unique.push_back({{4, 4}, 6});  // a self loop is invalid
+        LoadReport appended = g.appendUniqueEdges(unique);
+        CHECK(appended.added == 2);
+        CHECK(appended.invalid == 1);
+        CHECK(g.degree(4) == 3);
+        CHECK(g.getNumOfEdges() == 10);
+
+        UnweightedGraph u(3);
+        CHECK(u.tryAddEdge(1, 2, 5) == EdgeStatus::InvalidWeight);
+        CHECK(u.tryAddEdge(1, 2) == EdgeStatus::Added);
+        CHECK(u.getNumOfEdges() == 2);
+    }
+
     SUBCASE("Invalid operations"){
         Graph g(3);
         // Invalid vertices
@@ -349,6 +1319,1003 @@ TEST_CASE("Graph tests"){
         
         g.addEdge(2, 3, -2);
         CHECK(g.hasNegativeEdge() == true);
+
+        g.removeEdge(2, 3);
+        CHECK(g.hasNegativeEdge() == true);    // 3->2 is still negative
+        g.removeEdge(3, 2);
+        CHECK(g.hasNegativeEdge() == false);
+    }
+
+    SUBCASE("Statistics follow adds and removes"){
+        Graph g(4);
+        CHECK(g.getNumOfEdges() == 0);
+        CHECK_THROWS_AS(g.getMinWeight(), std::invalid_argument);
+        g.addEdge(1, 2, 5);
+        g.addDirectedEdge(3, 2, -4);
+        g.addDirectedEdge(4, 2, 9);
+        g.addDirectedEdge(1, 3, 2);
+        CHECK(g.getNumOfEdges() == 5);
+        CHECK(g.degree(1) == 2);
+        CHECK(g.inDegree(2) == 3);
+        CHECK(g.inDegree(4) == 0);
+        CHECK(g.getMinWeight() == -4);
+        CHECK(g.getMaxWeight() == 9);
+        CHECK(g.hasNegativeEdge() == true);
+
+        // removing the edges on the border of the range forces a recompute
+        g.removeEdge(4, 2);
+        CHECK(g.getMaxWeight() == 5);
+        DynamicArray<Pair<int, int>> batch;
+        batch.push_back({3, 2});
+        batch.push_back({1, 3});
+        CHECK(g.removeEdges(batch) == 2);
+        CHECK(g.getMinWeight() == 5);
+        CHECK(g.hasNegativeEdge() == false);
+        CHECK(g.getNumOfEdges() == 2);
+        CHECK(g.inDegree(2) == 1);
+
+        Graph copy(g);
+        Graph moved(std::move(g));
+        CHECK(copy.getNumOfEdges() == 2);
+        CHECK(moved.inDegree(1) == 1);
+        moved.removeEdge(1, 2);
+        moved.removeEdge(2, 1);
+        CHECK(moved.getNumOfEdges() == 0);
+        moved.addDirectedEdge(2, 1, 7);
+        CHECK(moved.getMinWeight() == 7);
+        CHECK(moved.getMaxWeight() == 7);
+        CHECK_THROWS_AS(moved.inDegree(5), std::invalid_argument);
+    }
+}
+
+TEST_CASE("CompressedGraph tests"){
+    SUBCASE("Same edges as the original graph"){
+        Graph g(5);
+        g.addEdge(1, 4, 10);
+        g.addEdge(1, 2, -3);
+        g.addDirectedEdge(1, 3, 7);
+        g.addEdge(2, 5, 300);   // needs more than one varint byte
+        g.addDirectedEdge(3, 1, 7);
+
+        CompressedGraph cg(g);
+        CHECK(cg.getNumOfVertices() == 5);
+        CHECK(cg.getNumOfEdges() == 8);
+        CHECK(cg.hasUnitWeights() == false);
+        CHECK(cg.hasNegativeEdge() == true);
+        CHECK(cg.degree(1) == 3);
+        CHECK(cg.degree(3) == 1);
+        CHECK(cg.hasEdge(3, 1) == true);
+        CHECK(cg.hasEdge(1, 5) == false);
+        CHECK(cg.hasEdge(5, 2) == true);
+
+        // neighbors are decoded in sorted order with their weights
+        int expectedNeighbors[] = {2, 3, 4};
+        int expectedWeights[] = {-3, 7, 10};
+        int i = 0;
+        for(const Pair<int, int>& edge : cg.neighbors(1)){
+            CHECK(edge.first == expectedNeighbors[i]);
+            CHECK(edge.second == expectedWeights[i]);
+            i++;
+        }
+        CHECK(i == 3);
+    }
+
+    SUBCASE("Unit weights are not stored"){
+        Graph g(4);
+        g.addEdge(1, 2);
+        g.addEdge(2, 3);
+        g.addEdge(3, 4);
+
+        CompressedGraph cg(g);
+        CHECK(cg.hasUnitWeights() == true);
+        CHECK(cg.getCompressedSize() == 6);    // one byte per directed edge
+        for(const Pair<int, int>& edge : cg.neighbors(2)){
+            CHECK(edge.second == 1);
+        }
+
+        // copies are independent
+        CompressedGraph copy(cg);
+        CHECK(copy.getCompressedSize() == cg.getCompressedSize());
+        CHECK(copy.hasEdge(4, 3) == true);
+
+        CompressedGraph taken(std::move(copy));
+        CompressedGraph fromMoved(copy);    // the moved from graph has no buffers
+        CHECK(fromMoved.getCompressedSize() == 0);
+        CHECK(taken.hasEdge(4, 3) == true);
+    }
+
+    SUBCASE("Traversal on the compressed graph"){
+        Graph g(6);
+        g.addEdge(1, 2);
+        g.addEdge(1, 3);
+        g.addEdge(2, 4);
+        g.addEdge(2, 5);
+        g.addEdge(3, 5);
+        g.addEdge(4, 6);
+        g.addEdge(5, 6);
+
+        CompressedGraph cg(g);
+        Graph bfsTree = bfs(cg, 1);
+        CHECK(bfsTree.hasEdge(1, 2) == true);
+        CHECK(bfsTree.hasEdge(1, 3) == true);
+        CHECK(bfsTree.hasEdge(2, 4) == true);
+        CHECK(bfsTree.hasEdge(2, 5) == true);
+        CHECK(bfsTree.hasEdge(4, 6) == true);
+
+        Graph dfsTree = dfs(cg, 1);
+        int edgeCount = 0;
+        for(int i = 1; i <= 6; i++){
+            edgeCount += dfsTree.getNeighbors(i).getSize();
+        }
+        CHECK(edgeCount == 5);
+        CHECK_THROWS_AS(bfs(cg, 7), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Graph with other vertex and weight types"){
+    SUBCASE("8 bit weights are printed as numbers"){
+        BasicGraph<uint32_t, uint8_t> g(2);
+        g.addEdge(1, 2, 200);
+
+        std::stringstream buffer;
+        CoutRedirect redirect(buffer);
+        g.printGraph();
+        CHECK(buffer.str() == "{1->2 (200)}\n{2->1 (200)}\n");
+    }
+
+    SUBCASE("64 bit weights don't overflow on long paths"){
+        BasicGraph<uint32_t, int64_t> g(4);
+        g.addEdge(1, 2, 3000000000LL);
+        g.addEdge(2, 3, 3000000000LL);
+        g.addEdge(3, 4, 3000000000LL);
+        g.addEdge(1, 4, 9500000000LL);
+
+        BasicGraph<uint32_t, int64_t> tree = dijkstra(g, 1u);
+        CHECK(tree.hasEdge(3, 4) == true);
+        CHECK(tree.hasEdge(1, 4) == false);
+    }
+
+    SUBCASE("Floating point weights"){
+        BasicGraph<uint32_t, float> g(3);
+        g.addEdge(1, 2, 0.5f);
+        g.addEdge(2, 3, 0.25f);
+        g.addEdge(1, 3, 1.0f);
+
+        BasicGraph<uint32_t, float> tree = dijkstra(g, 1u);
+        CHECK(tree.hasEdge(2, 3) == true);
+        CHECK(tree.hasEdge(1, 3) == false);
+
+        BasicGraph<uint32_t, float> mst = kruskal(g);
+        CHECK(mst.hasEdge(1, 2) == true);
+        CHECK(mst.hasEdge(2, 3) == true);
+
+        BasicCompressedGraph<uint32_t, float> cg(g);
+        float total = 0;
+        for(const Pair<uint32_t, float>& edge : cg.neighbors(1)){
+            total += edge.second;
+        }
+        CHECK(total == doctest::Approx(1.5));
+    }
+}
+
+TEST_CASE("Unweighted graph tests"){
+    SUBCASE("Only neighbor ids are stored"){
+        UnweightedGraph g(4);
+        g.addEdge(1, 2);
+        g.addEdge(2, 3);
+        g.addDirectedEdge(3, 4);
+        CHECK_THROWS_AS(g.addEdge(1, 3, 5), std::invalid_argument);    // only weight 1 is allowed
+        g.addEdge(1, 4, 1);
+
+        CHECK(sizeof(UnweightedGraph::edge_type) == sizeof(int));
+        CHECK(g.hasEdge(2, 1) == true);
+        CHECK(g.hasEdge(4, 3) == false);
+        CHECK(g.hasNegativeEdge() == false);
+
+        ArrayView<int> list = g.neighbors(2);
+        CHECK(list.getSize() == 2);
+
+        // getNeighbors still returns (neighbor, weight) pairs
+        DynamicArray<Pair<int, int>> neighbors = g.getNeighbors(1);
+        CHECK(neighbors.getSize() == 2);
+        CHECK(neighbors[0].first == 2);
+        CHECK(neighbors[0].second == 1);
+
+        std::stringstream buffer;
+        CoutRedirect redirect(buffer);
+        g.printGraph();
+        CHECK(buffer.str() == "{1->2 (1)}, {1->4 (1)}\n{2->1 (1)}, {2->3 (1)}\n{3->2 (1)}, {3->4 (1)}\n{4->1 (1)}\n");
+    }
+
+    SUBCASE("Algorithms on an unweighted graph"){
+        UnweightedGraph g(6);
+        g.addEdge(1, 2);
+        g.addEdge(1, 3);
+        g.addEdge(2, 4);
+        g.addEdge(2, 5);
+        g.addEdge(3, 5);
+        g.addEdge(4, 6);
+        g.addEdge(5, 6);
+
+        UnweightedGraph bfsTree = bfs(g, 1);
+        CHECK(bfsTree.hasEdge(1, 2) == true);
+        CHECK(bfsTree.hasEdge(1, 3) == true);
+        CHECK(bfsTree.hasEdge(2, 4) == true);
+        CHECK(bfsTree.hasEdge(2, 5) == true);
+        CHECK(bfsTree.hasEdge(4, 6) == true);
+
+        UnweightedGraph dijkstraTree = dijkstra(g, 1);
+        CHECK(dijkstraTree.hasEdge(1, 2) == true);
+        CHECK((dijkstraTree.hasEdge(4, 6) || dijkstraTree.hasEdge(5, 6)) == true);
+
+        int edgeCount = 0;
+        UnweightedGraph mst = kruskal(g);
+        for(int i = 1; i <= 6; i++){
+            edgeCount += mst.neighbors(i).getSize();
+        }
+        CHECK(edgeCount == 5);
+    }
+
+    SUBCASE("Kruskal on a large unweighted graph"){
+        // every weight is 1, a sort that is quadratic on equal keys would take minutes here
+        UnweightedGraph g = grid<UnweightedGraph>(300, 300);
+        UnweightedGraph mst = kruskal(g);
+        CHECK(mst.getNumOfEdges() == 300 * 300 - 1);      // a spanning tree of the connected grid
+    }
+}
+
+TEST_CASE("VersionedGraph tests"){
+    SUBCASE("Changes are visible only after publish"){
+        VersionedGraph vg(5);
+        GraphSnapshot empty = vg.snapshot();
+        CHECK(vg.tryAddEdge(1, 2, 4) == EdgeStatus::Added);
+        CHECK(vg.tryAddDirectedEdge(2, 3, 6) == EdgeStatus::Added);
+        CHECK(vg.tryAddEdge(2, 1, 4) == EdgeStatus::AlreadyExists);
+        CHECK(vg.tryAddEdge(1, 1, 4) == EdgeStatus::Invalid);
+        CHECK(vg.hasPendingChanges() == true);
+        CHECK(vg.snapshot().getNumOfEdges() == 0);
+
+        CHECK(vg.publish() == 1);
+        CHECK(vg.hasPendingChanges() == false);
+        CHECK(vg.publish() == 1);       // nothing new
+        GraphSnapshot first = vg.snapshot();
+        CHECK(first.getVersion() == 1);
+        CHECK(first.getNumOfEdges() == 3);
+        CHECK(first.hasEdge(1, 2) == true);
+        CHECK(first.hasEdge(3, 2) == false);
+        CHECK(first.degree(2) == 2);
+
+        vg.removeEdge(1, 2);
+        CHECK_THROWS_AS(vg.removeEdge(1, 2), std::invalid_argument);
+        CHECK(vg.tryAddEdge(4, 5, -1) == EdgeStatus::Added);
+        vg.publish();
+        GraphSnapshot second = vg.snapshot();
+        CHECK(second.hasEdge(1, 2) == false);
+        CHECK(second.hasNegativeEdge() == true);
+        CHECK(first.hasEdge(1, 2) == true);     // the old versions don't change
+        CHECK(first.hasNegativeEdge() == false);
+        CHECK(empty.getNumOfEdges() == 0);
+    }
+
+    SUBCASE("Unchanged lists are shared between versions"){
+        Graph g(200);
+        for(int v = 1; v < 200; v++){
+            g.addEdge(v, v + 1, v);
+        }
+        VersionedGraph vg(g);
+        GraphSnapshot before = vg.snapshot();
+        CHECK(before.getNumOfEdges() == g.getNumOfEdges());
+        vg.tryAddEdge(1, 150, 7);
+        vg.publish();
+        GraphSnapshot after = vg.snapshot();
+        CHECK(after.neighbors(100).begin() == before.neighbors(100).begin());
+        CHECK(after.neighbors(2).begin() == before.neighbors(2).begin());
+        CHECK(after.neighbors(1).begin() != before.neighbors(1).begin());
+        CHECK(after.degree(1) == before.degree(1) + 1);
+
+        Graph copy = after.toGraph();
+        CHECK(copy.getNumOfEdges() == after.getNumOfEdges());
+        CHECK(copy.hasEdge(150, 1) == true);
+    }
+
+    SUBCASE("Algorithms run on snapshots"){
+        Graph g(5);
+        g.addEdge(1, 2, 10);
+        g.addEdge(1, 3, 5);
+        g.addEdge(2, 3, 2);
+        g.addEdge(2, 4, 1);
+        g.addEdge(3, 4, 9);
+        g.addEdge(3, 5, 2);
+        g.addEdge(4, 5, 4);
+        VersionedGraph vg(g);
+        GraphSnapshot snapshot = vg.snapshot();
+        Graph fromGraph = dijkstra(g, 1);
+        Graph fromSnapshot = dijkstra(snapshot, 1);
+        Graph mst = kruskal(snapshot);
+        Graph expectedMst = kruskal(g);
+        for(int u = 1; u <= 5; u++){
+            for(int v = 1; v <= 5; v++){
+                CHECK(fromSnapshot.hasEdge(u, v) == fromGraph.hasEdge(u, v));
+                CHECK(mst.hasEdge(u, v) == expectedMst.hasEdge(u, v));
+            }
+        }
+        CHECK(kHopNeighborhood(snapshot, 1, 1).getSize() == 2);
+
+        UnweightedVersionedGraph unweighted(3);
+        CHECK(unweighted.tryAddEdge(1, 2, 3) == EdgeStatus::InvalidWeight);
+        CHECK(unweighted.tryAddEdge(1, 2) == EdgeStatus::Added);
+        unweighted.publish();
+        UnweightedGraphSnapshot unweightedSnapshot = unweighted.snapshot();
+        CHECK(bfs(unweightedSnapshot, 1).hasEdge(1, 2) == true);
+    }
+
+    SUBCASE("Readers run while the writer publishes"){
+        const int n = 300;
+        VersionedGraph vg(n);
+        std::atomic<bool> done(false);
+        std::atomic<int> badSnapshots(0);
+        DynamicArray<std::thread> readers;
+        for(int r = 0; r < 3; r++){
+            readers.emplace_back([&vg, &done, &badSnapshots](){
+                while(!done.load()){
+                    GraphSnapshot snapshot = vg.snapshot();
+                    // the writer publishes after every edge of the path 1 - 2 - ... so version k holds k edges
+                    Graph tree = bfs(snapshot, 1);
+                    if(snapshot.getNumOfEdges() != 2 * (long long)snapshot.getVersion() || tree.getNumOfEdges() != snapshot.getNumOfEdges() / 2){
+                        badSnapshots++;
+                    }
+                }
+            });
+        }
+        for(int v = 1; v < n; v++){
+            vg.tryAddEdge(v, v + 1, 1);
+            vg.publish();
+        }
+        done = true;
+        for(std::thread& reader : readers){
+            reader.join();
+        }
+        CHECK(badSnapshots.load() == 0);
+        CHECK(vg.snapshot().getNumOfEdges() == 2 * (n - 1));
+    }
+}
+
+TEST_CASE("ConcurrentGraph tests"){
+    SUBCASE("The same statuses as Graph"){
+        ConcurrentGraph cg(5, 2);
+        CHECK(cg.getNumOfShards() == 2);
+        CHECK(cg.tryAddEdge(1, 2, 4) == EdgeStatus::Added);
+        CHECK(cg.tryAddEdge(2, 1, 4) == EdgeStatus::AlreadyExists);
+        CHECK(cg.tryAddDirectedEdge(3, 4, 2) == EdgeStatus::Added);
+        CHECK(cg.tryAddEdge(4, 3, 2) == EdgeStatus::BackwardExisted);
+        CHECK(cg.tryAddEdge(1, 1, 4) == EdgeStatus::Invalid);
+        CHECK(cg.tryAddEdge(1, 6, 4) == EdgeStatus::Invalid);
+        CHECK(cg.getNumOfEdges() == 4);
+        CHECK(cg.degree(3) == 1);
+        CHECK(cg.hasEdge(4, 3) == true);
+
+        cg.removeEdge(1, 2);
+        CHECK_THROWS_AS(cg.removeEdge(1, 2), std::invalid_argument);
+        CHECK(cg.tryAddDirectedEdge(2, 5, -3) == EdgeStatus::Added);
+        CHECK(cg.hasNegativeEdge() == true);
+        Graph frozen = cg.freeze();
+        CHECK(frozen.getNumOfEdges() == 4);
+        CHECK(frozen.hasEdge(2, 1) == true);
+        CHECK(frozen.hasEdge(1, 2) == false);
+        CHECK(frozen.hasNegativeEdge() == true);
+
+        UnweightedConcurrentGraph unweighted(3);
+        CHECK(unweighted.tryAddEdge(1, 2, 3) == EdgeStatus::InvalidWeight);
+        CHECK(unweighted.tryAddEdge(1, 2) == EdgeStatus::Added);
+        UnweightedGraph unweightedFrozen = unweighted.freeze();
+        CHECK(bfs(unweightedFrozen, 1).hasEdge(1, 2) == true);
+        CHECK_THROWS_AS(ConcurrentGraph(3, 0), std::invalid_argument);
+    }
+
+    SUBCASE("Freeze copies the lists without an array of all the edges"){
+        const int n = 2000;
+        ConcurrentGraph cg(n);
+        for(int v = 1; v <= n; v++){
+            for(int k = 1; k <= 4; k++){
+                cg.tryAddEdge(v, (v + k * 13) % n + 1, k);
+            }
+        }
+        size_t peak;
+        size_t reserved;
+        {
+            AllocationScope scope;
+            Graph frozen = cg.freeze();
+            peak = scope.peakBytes();
+            reserved = frozen.memoryUsage().reserved;
+            CHECK(frozen.getNumOfEdges() == cg.getNumOfEdges());
+        }
+        CHECK(peak <= reserved + 1024);     // only the graph itself is allocated
+        Graph direct(n);
+        ArrayView<Pair<int, int>> none(nullptr, 0);
+        CHECK(direct.appendUniqueEdges(1, none).total() == 0);
+        Pair<int, int> entries[3] = {Pair<int, int>(2, 5), Pair<int, int>(1, 5), Pair<int, int>(n + 1, 5)};
+        LoadReport report = direct.appendUniqueEdges(1, ArrayView<Pair<int, int>>(entries, 3));
+        CHECK(report.added == 1);
+        CHECK(report.invalid == 2);     // a self loop and a vertex out of range
+        CHECK(direct.hasEdge(1, 2) == true);
+    }
+
+    SUBCASE("Threads add the same edges, every edge is added once"){
+        const int n = 500;
+        ConcurrentGraph cg(n, 8);
+        std::atomic<int> added(0);
+        DynamicArray<std::thread> writers;
+        for(int t = 0; t < 4; t++){
+            writers.emplace_back([&cg, &added, t](){
+                // every thread adds all the edges, from a different starting vertex and direction
+                for(int i = 0; i < n - 1; i++){
+                    int v = (i + t * 97) % (n - 1) + 1;
+                    EdgeStatus status = t % 2 == 0 ? cg.tryAddEdge(v, v + 1, v) : cg.tryAddEdge(v + 1, v, v);
+                    if(status == EdgeStatus::Added) added++;
+                    if(v + 3 <= n && cg.tryAddDirectedEdge(v, v + 3, -v) == EdgeStatus::Added) added++;
+                }
+            });
+        }
+        for(std::thread& writer : writers){
+            writer.join();
+        }
+        CHECK(added.load() == (n - 1) + (n - 3));
+        CHECK(cg.getNumOfEdges() == 2 * (n - 1) + (n - 3));
+
+        Graph expected(n);
+        for(int v = 1; v < n; v++){
+            expected.addEdge(v, v + 1, v);
+            if(v + 3 <= n) expected.addDirectedEdge(v, v + 3, -v);
+        }
+        Graph frozen = cg.freeze();
+        CompressedGraph compressed(frozen);
+        int wrong = 0;
+        for(int v = 1; v <= n; v++){
+            if(frozen.degree(v) != expected.degree(v) || compressed.degree(v) != expected.degree(v)) wrong++;
+            if(frozen.hasEdge(v, v + 3) != expected.hasEdge(v, v + 3)) wrong++;
+        }
+        CHECK(wrong == 0);
+    }
+
+    SUBCASE("Parallel load and removal"){
+        const int n = 400;
+        DynamicArray<Pair<Pair<int, int>, int>> edges;
+        for(int v = 1; v < n; v++){
+            edges.push_back(Pair<Pair<int, int>, int>(Pair<int, int>(v, v + 1), 1));
+            edges.push_back(Pair<Pair<int, int>, int>(Pair<int, int>(v + 1, v), 1));   // a duplicate
+        }
+        edges.push_back(Pair<Pair<int, int>, int>(Pair<int, int>(0, 1), 1));
+        ThreadPool pool(4);
+        ConcurrentGraph cg(n);
+        LoadReport report = cg.loadEdges(edges, false, pool);
+        CHECK(report.added == n - 1);
+        CHECK(report.duplicates == n - 1);
+        CHECK(report.invalid == 1);
+        CHECK(report.total() == edges.getSize());
+
+        pool.parallel_for(1, n, [&cg](long v){
+            cg.removeEdge((int)v + 1, (int)v);
+        });
+        CHECK(cg.getNumOfEdges() == n - 1);
+        Graph path = cg.freeze();
+        Graph tree = bfs(path, 1);
+        CHECK(tree.getNumOfEdges() == n - 1);     // the directed path still reaches every vertex
+    }
+}
+
+TEST_CASE("Graph views"){
+    Graph g(6);
+    g.addEdge(1, 2, 4);
+    g.addEdge(2, 3, 1);
+    g.addEdge(3, 4, 7);
+    g.addEdge(1, 4, 2);
+    g.addEdge(4, 5, -3);
+    g.addDirectedEdge(5, 6, 9);
+
+    SUBCASE("Induced subgraph"){
+        DynamicArray<int> vertices;
+        vertices.push_back(1);
+        vertices.push_back(2);
+        vertices.push_back(3);
+        vertices.push_back(2);
+        SubgraphView view(g, vertices);
+        CHECK(view.getNumOfVertices() == 6);
+        CHECK(view.getNumOfSelected() == 3);
+        CHECK(view.contains(4) == false);
+        CHECK(view.hasNegativeEdge() == false);     // 4 - 5 is outside
+        CHECK_THROWS_AS(view.neighbors(7), std::invalid_argument);
+
+        Graph tree = dijkstra(view, 1);
+        CHECK(tree.hasEdge(1, 2) == true);
+        CHECK(tree.hasEdge(2, 3) == true);
+        CHECK(tree.hasEdge(1, 4) == false);
+        CHECK(tree.getNumOfEdges() == 2);
+
+        Graph copy = view.toGraph();
+        CHECK(copy.getNumOfEdges() == 4);
+        CHECK(copy.hasEdge(3, 2) == true);
+        CHECK(copy.hasEdge(3, 4) == false);
+
+        vertices.push_back(5);
+        vertices.push_back(4);
+        SubgraphView withNegative(g, vertices);
+        CHECK(withNegative.hasNegativeEdge() == true);
+        CHECK_THROWS_AS(dijkstra(withNegative, 1), std::invalid_argument);
+        vertices.push_back(9);
+        CHECK_THROWS_AS(SubgraphView(g, vertices), std::invalid_argument);
+    }
+
+    SUBCASE("Edge filters"){
+        EdgeFilterView light(g, 0, 4);
+        CHECK(light.hasNegativeEdge() == false);
+        Graph tree = bfs(light, 1);
+        CHECK(tree.hasEdge(1, 2) == true);
+        CHECK(tree.hasEdge(1, 4) == true);
+        CHECK(tree.hasEdge(4, 5) == false);
+        CHECK(tree.getNumOfEdges() == 3);
+        CHECK(isReachable(light, 1, 5) == false);
+        CHECK(isReachable(g, 1, 5) == true);
+
+        EdgeFilterView all(g);
+        CHECK(all.hasNegativeEdge() == true);
+        EdgeFilterView aboveMin(g, -1);     // -3 is the smallest weight, below the range
+        CHECK(aboveMin.hasNegativeEdge() == false);
+        CHECK(dijkstra(aboveMin, 1).hasEdge(4, 5) == false);
+        Graph directed(3);
+        directed.addDirectedEdge(1, 2, -5);
+        directed.addDirectedEdge(1, 3, 3);
+        EdgeFilterView positive(directed, -1);
+        CHECK(positive.hasNegativeEdge() == false);
+        CHECK(dijkstra(positive, 1).hasEdge(1, 3) == true);
+        CHECK(all.toGraph().getNumOfEdges() == g.getNumOfEdges());
+
+        // hides every edge that touches vertex 2, and the negative one by weight
+        int hidden = 2;
+        auto avoid = [&hidden](int src, int dest, int){ return src != hidden && dest != hidden; };
+        EdgeFilterView detour(g, avoid, -1);
+        CHECK(detour.hasNegativeEdge() == false);
+        Graph path = dijkstra(detour, 1);
+        CHECK(path.hasEdge(1, 2) == false);
+        CHECK(path.hasEdge(4, 3) == true);
+        CHECK(path.hasEdge(5, 6) == false);
+
+        // an inline lambda is copied into the view, nothing dangles after the constructor
+        EdgeFilterView inlined(g, [hidden](int src, int dest, int){ return src != hidden && dest != hidden; }, -1);
+        Graph reached = bfs(inlined, 1);
+        CHECK(reached.hasEdge(1, 2) == false);
+        CHECK(reached.getNumOfEdges() == bfs(detour, 1).getNumOfEdges());
+
+        UnweightedGraph unweighted(4);
+        unweighted.addEdge(1, 2);
+        unweighted.addEdge(2, 3);
+        unweighted.addEdge(3, 4);
+        DynamicArray<int> vertices;
+        vertices.push_back(2);
+        vertices.push_back(3);
+        vertices.push_back(4);
+        UnweightedSubgraphView tail(unweighted, vertices);
+        CHECK(kHopNeighborhood(tail, 2, 5).getSize() == 2);
+        CHECK(bfs(tail, 1).getNumOfEdges() == 0);
+    }
+}
+
+TEST_CASE("External memory algorithms"){
+    SUBCASE("BFS and components from a binary file"){
+        GeneratorOptions options;
+        options.seed = 11;
+        options.directed = true;
+        Graph g = gnm<Graph>(400, 500, options);
+        std::stringstream file;
+        writeBinary(g, file);
+
+        ExternalStats stats;
+        DynamicArray<int> dist = externalBfs<Graph>(file, 7, &stats, 100);     // a few records per block
+        DynamicArray<int> expected = hopLevels(g, 7);
+        int wrong = 0;
+        for(int v = 0; v < 400; v++){
+            if(dist[v] != expected[v]) wrong++;
+        }
+        CHECK(wrong == 0);
+        CHECK(stats.passes >= 2);       // the last pass changes nothing
+        CHECK(stats.bytesRead == (uint64_t)stats.passes * g.getNumOfEdges() * 3 * sizeof(int));
+
+        // weak components: a vertex is in the component of 1 iff bfs from 1 on the undirected copy reaches it
+        Graph undirected(400);
+        for(int v = 1; v <= 400; v++){
+            for(const auto& edge : g.neighbors(v)){
+                undirected.tryAddEdge(v, edge.first, edge.second);
+            }
+        }
+        file.clear();
+        file.seekg(0);
+        ExternalStats componentStats;
+        DynamicArray<int> labels = externalConnectedComponents<Graph>(file, &componentStats);
+        CHECK(componentStats.passes == 1);
+        DynamicArray<int> fromOne = hopLevels(undirected, 1);
+        wrong = 0;
+        for(int v = 1; v <= 400; v++){
+            if((labels[v - 1] == 1) != (fromOne[v - 1] >= 0) || labels[v - 1] > v) wrong++;
+            if(labels[labels[v - 1] - 1] != labels[v - 1]) wrong++;
+        }
+        CHECK(wrong == 0);
+    }
+
+    SUBCASE("Compressed graph from a binary file"){
+        GeneratorOptions options;
+        options.seed = 5;
+        options.minWeight = -20;
+        Graph g = gnm<Graph>(300, 1200, options);
+        std::stringstream file;
+        writeBinary(g, file);
+
+        ExternalStats stats;
+        CompressedGraph streamed = readCompressed<Graph>(file, &stats, 100);
+        CompressedGraph expected(g);
+        CHECK(stats.passes == 2);
+        CHECK(streamed.getNumOfEdges() == expected.getNumOfEdges());
+        CHECK(streamed.getCompressedSize() == expected.getCompressedSize());
+        CHECK(streamed.hasNegativeEdge() == expected.hasNegativeEdge());
+        int wrong = 0;
+        for(int v = 1; v <= 300; v++){
+            if(streamed.degree(v) != expected.degree(v)) wrong++;
+            auto other = expected.neighbors(v).begin();
+            for(const Pair<int, int>& edge : streamed.neighbors(v)){
+                if(edge.first != other->first || edge.second != other->second) wrong++;
+                ++other;
+            }
+        }
+        CHECK(wrong == 0);
+
+        UnweightedGraph unweighted(4);
+        unweighted.addEdge(1, 2);
+        unweighted.addEdge(2, 4);
+        std::stringstream unitFile;
+        writeBinary(unweighted, unitFile);
+        CompressedGraph unit = readCompressed<UnweightedGraph>(unitFile);
+        CHECK(unit.hasUnitWeights() == true);
+        CHECK(unit.getCompressedSize() == 4);   // one byte per entry, no weights
+        CHECK(unit.hasEdge(4, 2) == true);
+        CHECK(unit.degree(3) == 0);
+
+        // the records of vertex 1 after the ones of vertex 2
+        Graph two(3);
+        two.addDirectedEdge(1, 2, 4);
+        two.addDirectedEdge(2, 3, 5);
+        std::stringstream ordered;
+        writeBinary(two, ordered);
+        std::string header = ordered.str().substr(0, sizeof(BinaryHeader));
+        std::string first = ordered.str().substr(sizeof(BinaryHeader), 3 * sizeof(int));
+        std::string second = ordered.str().substr(sizeof(BinaryHeader) + 3 * sizeof(int));
+        std::stringstream swapped(header + second + first);
+        CHECK_THROWS_AS(readCompressed<Graph>(swapped), std::invalid_argument);
+
+        CompressedGraphBuilder builder(3, false);
+        Pair<int, int> repeated[2] = {Pair<int, int>(2, 1), Pair<int, int>(2, 3)};
+        CHECK_THROWS_AS(builder.addList(1, repeated, 2), std::invalid_argument);
+    }
+
+    SUBCASE("Bad files"){
+        Graph g(3);
+        g.addEdge(1, 2, 1);
+        std::stringstream file;
+        writeBinary(g, file);
+        CHECK_THROWS_AS(externalBfs<Graph>(file, 4), std::invalid_argument);
+        using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+        std::stringstream wrongTypes(file.str());
+        CHECK_THROWS_AS(externalConnectedComponents<GraphU8>(wrongTypes), std::invalid_argument);
+        std::stringstream truncated(file.str().substr(0, file.str().size() - 4));
+        CHECK_THROWS_AS(externalBfs<Graph>(truncated, 1), std::invalid_argument);
+        CHECK_THROWS_AS(externalConnectedComponents<Graph>(std::string("/nonexistent/graph.bin")), std::invalid_argument);
+
+        std::stringstream isolated(file.str());
+        DynamicArray<int> labels = externalConnectedComponents<Graph>(isolated);
+        CHECK(labels[1] == 1);
+        CHECK(labels[2] == 3);
+    }
+}
+
+// plain power iteration, every rank pushed to the out neighbors
+template <typename G>
+static DynamicArray<double> naivePageRank(G& g, double damping, int iterations){
+    int n = (int)g.getNumOfVertices();
+    DynamicArray<double> rank;
+    for(int v = 0; v < n; v++){
+        rank.push_back(1.0 / n);
+    }
+    for(int it = 0; it < iterations; it++){
+        DynamicArray<double> next;
+        for(int v = 0; v < n; v++){
+            next.push_back((1 - damping) / n);
+        }
+        for(int u = 1; u <= n; u++){
+            int degree = g.degree(u);
+            for(const auto& edge : g.neighbors(u)){
+                next[(int)edgeTarget(edge) - 1] += damping * rank[u - 1] / degree;
+            }
+            if(degree == 0){
+                for(int v = 0; v < n; v++){
+                    next[v] += damping * rank[u - 1] / n;
+                }
+            }
+        }
+        rank = std::move(next);
+    }
+    return rank;
+}
+
+TEST_CASE("PageRank"){
+    SUBCASE("Matches plain power iteration"){
+        GeneratorOptions options;
+        options.seed = 5;
+        options.directed = true;
+        Graph g = gnm<Graph>(9000, 40000, options);     // a few blocks, with dangling vertices
+        PageRankOptions fixed;
+        fixed.tolerance = 0;
+        fixed.maxIterations = 30;
+        PageRankResult result = pageRank(g, fixed);
+        CHECK(result.iterations == 30);
+        CHECK(result.converged == false);
+        DynamicArray<double> expected = naivePageRank(g, 0.85, 30);
+        double sum = 0;
+        int wrong = 0;
+        for(int v = 0; v < 9000; v++){
+            sum += result.ranks[v];
+            if(std::abs(result.ranks[v] - expected[v]) > 1e-12) wrong++;
+        }
+        CHECK(wrong == 0);
+        CHECK(sum == doctest::Approx(1.0));
+
+        ThreadPool pool(4);
+        PageRankEngine<int> engine(g);
+        CHECK(engine.getNumOfEdges() == g.getNumOfEdges());
+        PageRankOptions parallel;
+        parallel.pool = &pool;
+        PageRankResult sequentialRun = engine.pageRank();
+        PageRankResult parallelRun = engine.pageRank(parallel);
+        CHECK(sequentialRun.converged == true);
+        CHECK(sequentialRun.residual < 1e-9);
+        CHECK(parallelRun.iterations == sequentialRun.iterations);
+        wrong = 0;
+        for(int v = 0; v < 9000; v++){
+            if(parallelRun.ranks[v] != sequentialRun.ranks[v]) wrong++;     // the same blocks, the same sums
+        }
+        CHECK(wrong == 0);
+
+        CompressedGraph compressed(g);
+        CHECK(pageRank(compressed).ranks[17] == sequentialRun.ranks[17]);
+    }
+
+    SUBCASE("Small graphs and personalization"){
+        Graph cycle(4);
+        for(int v = 1; v <= 4; v++){
+            cycle.addDirectedEdge(v, v % 4 + 1, 3);
+        }
+        PageRankResult uniform = pageRank(cycle);
+        CHECK(uniform.ranks[2] == doctest::Approx(0.25));
+
+        UnweightedGraph star(5);
+        for(int v = 2; v <= 5; v++){
+            star.addEdge(1, v);
+        }
+        PageRankResult hub = pageRank(star);
+        CHECK(hub.ranks[0] > 2 * hub.ranks[1]);
+
+        // vertices 3 and 4 are not reachable from the seed
+        Graph split(4);
+        split.addEdge(1, 2, 1);
+        split.addEdge(3, 4, 1);
+        DynamicArray<int> seeds;
+        seeds.push_back(1);
+        PageRankResult personal = personalizedPageRank(split, seeds);
+        CHECK(personal.ranks[0] + personal.ranks[1] == doctest::Approx(1.0));
+        CHECK(personal.ranks[2] == 0);
+        CHECK(personal.ranks[0] > personal.ranks[1]);
+
+        PageRankOptions bad;
+        bad.damping = 1;
+        CHECK_THROWS_AS(pageRank(split, bad), std::invalid_argument);
+        CHECK_THROWS_AS(personalizedPageRank(split, DynamicArray<int>()), std::invalid_argument);
+        seeds.push_back(5);
+        CHECK_THROWS_AS(personalizedPageRank(split, seeds), std::invalid_argument);
+        Graph empty(0);
+        CHECK(pageRank(empty).ranks.getSize() == 0);
+    }
+}
+
+TEST_CASE("Graph exporters"){
+    Graph g(4);
+    g.addEdge(1, 2, 5);
+    g.addDirectedEdge(2, 3, -7);
+
+    SUBCASE("Edge list"){
+        std::stringstream out;
+        writeEdgeList(g, out);
+        CHECK(out.str() == "1 2 5\n2 1 5\n2 3 -7\n");
+    }
+
+    SUBCASE("DOT"){
+        std::stringstream directed;
+        writeDot(g, directed);
+        CHECK(directed.str() == "digraph G {\n  1 -> 2 [label=5];\n  2 -> 1 [label=5];\n  2 -> 3 [label=-7];\n  3;\n  4;\n}\n");
+        std::stringstream undirected;
+        writeDot(g, undirected, false);
+        CHECK(undirected.str() == "graph G {\n  1 -- 2 [label=5];\n  2 -- 3 [label=-7];\n  3;\n  4;\n}\n");
+    }
+
+    SUBCASE("Parallel chunks give the same output"){
+        Graph big(3000);
+        for(int v = 1; v < 3000; v++){
+            big.addEdge(v, v + 1, v % 17);
+            if(v + 7 <= 3000) big.addDirectedEdge(v, v + 7, -v);
+        }
+        ThreadPool pool(4);
+        std::stringstream sequential;
+        std::stringstream parallel;
+        writeEdgeList(big, sequential);
+        writeEdgeList(big, parallel, &pool);
+        CHECK(sequential.str() == parallel.str());
+        std::stringstream dotSequential;
+        std::stringstream dotParallel;
+        writeDot(big, dotSequential, true);
+        writeDot(big, dotParallel, true, &pool);
+        CHECK(dotSequential.str() == dotParallel.str());
+    }
+
+    SUBCASE("Other types and the compressed graph"){
+        BasicGraph<uint32_t, uint8_t> small(2);
+        small.addDirectedEdge(1, 2, 200);
+        std::stringstream bytes;
+        writeEdgeList(small, bytes);
+        CHECK(bytes.str() == "1 2 200\n");     // printed as a number, not as a character
+
+        BasicGraph<uint32_t, float> real(2);
+        real.addDirectedEdge(2, 1, 0.5f);
+        std::stringstream floats;
+        writeEdgeList(real, floats);
+        CHECK(floats.str() == "2 1 0.5\n");
+
+        CompressedGraph compressed(g);
+        std::stringstream out;
+        writeEdgeList(compressed, out);
+        CHECK(out.str() == "1 2 5\n2 1 5\n2 3 -7\n");
+    }
+
+    SUBCASE("Binary round trip"){
+        std::stringstream file;
+        writeBinary(g, file);
+        CHECK(file.str().size() == sizeof(BinaryHeader) + 3 * (2 * sizeof(int) + sizeof(int)));
+        Graph loaded = readBinary<Graph>(file);
+        CHECK(loaded.getNumOfVertices() == 4);
+        CHECK(loaded.getNumOfEdges() == 3);
+        CHECK(loaded.hasEdge(2, 3) == true);
+        CHECK(loaded.getMinWeight() == -7);
+
+        using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+        std::stringstream wrongTypes(file.str());
+        CHECK_THROWS_AS(readBinary<GraphU8>(wrongTypes), std::invalid_argument);
+        std::stringstream truncated(file.str().substr(0, file.str().size() - 4));
+        CHECK_THROWS_AS(readBinary<Graph>(truncated), std::invalid_argument);
+        std::stringstream garbage("not a graph at all, just some text");
+        CHECK_THROWS_AS(readBinary<Graph>(garbage), std::invalid_argument);
+
+        std::string records = file.str().substr(sizeof(BinaryHeader));
+        BinaryHeader header;
+        std::memcpy(&header, file.str().data(), sizeof(header));
+        header.numOfEdges = 4;
+        std::string twice(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::stringstream duplicated(twice + records + records.substr(0, 2 * sizeof(int) + sizeof(int)));
+        CHECK_THROWS_AS(readBinary<Graph>(duplicated), std::invalid_argument);
+        CHECK_THROWS_AS(readBinary<Graph>(std::string("/nonexistent/graph.bin")), std::invalid_argument);
+    }
+}
+
+// every entry has its reverse with the same weight
+template <typename G>
+static bool isSymmetric(const G& g){
+    for(typename G::vertex_type v = 1; v <= g.getNumOfVertices(); v++){
+        for(const auto& edge : g.neighbors(v)){
+            bool found = false;
+            for(const auto& back : g.neighbors(edgeTarget(edge))){
+                if(edgeTarget(back) == v && edgeWeight<typename G::weight_type>(back) == edgeWeight<typename G::weight_type>(edge)){
+                    found = true;
+                }
+            }
+            if(!found) return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Graph generators"){
+    ThreadPool pool(4);
+    GeneratorOptions options;
+    options.seed = 7;
+    GeneratorOptions parallel = options;
+    parallel.pool = &pool;
+
+    SUBCASE("R-MAT is deterministic and skewed"){
+        Graph a = rmat(12, 8, options);
+        Graph b = rmat(12, 8, parallel);
+        CHECK(a.getNumOfVertices() == 4096);
+        CHECK(a.getNumOfEdges() > 40000);     // 2 * 32768 entries before removing self loops and duplicates
+        CHECK(a.getNumOfEdges() <= 2 * 32768);
+        std::stringstream first;
+        std::stringstream second;
+        writeEdgeList(a, first);
+        writeEdgeList(b, second);
+        CHECK(first.str() == second.str());
+        CHECK(isSymmetric(a));
+        int maxDegree = 0;
+        for(int v = 1; v <= a.getNumOfVertices(); v++){
+            maxDegree = std::max(maxDegree, a.degree(v));
+        }
+        CHECK(maxDegree > 20 * a.getNumOfEdges() / a.getNumOfVertices());     // a few hubs
+
+        GeneratorOptions other = options;
+        other.seed = 8;
+        std::stringstream third;
+        writeEdgeList(rmat(12, 8, other), third);
+        CHECK(third.str() != first.str());
+        CHECK_THROWS_AS(rmat(27, 16, options), std::invalid_argument);     // 2^31 edges don't fit the edge array
+    }
+
+    SUBCASE("G(n, p)"){
+        Graph g = gnp(2000, 0.01, parallel);
+        double expected = 0.01 * 2000 * 1999;     // entries, both directions
+        CHECK(g.getNumOfEdges() > expected * 0.9);
+        CHECK(g.getNumOfEdges() < expected * 1.1);
+        CHECK(isSymmetric(g));
+        CHECK(gnp(50, 1.0).getNumOfEdges() == 50 * 49);
+        CHECK(gnp(50, 0.0).getNumOfEdges() == 0);
+        GeneratorOptions directed = options;
+        directed.directed = true;
+        CHECK(gnp(30, 1.0, directed).getNumOfEdges() == 30 * 29);
+        CHECK_THROWS_AS(gnp(10, 1.5), std::invalid_argument);
+    }
+
+    SUBCASE("G(n, m) has exactly m edges"){
+        Graph g = gnm(1000, 5000, options);
+        Graph h = gnm(1000, 5000, parallel);
+        CHECK(g.getNumOfEdges() == 10000);
+        std::stringstream first;
+        std::stringstream second;
+        writeEdgeList(g, first);
+        writeEdgeList(h, second);
+        CHECK(first.str() == second.str());
+        CHECK(gnm(10, 45).getNumOfEdges() == 90);     // the complete graph
+        CHECK_THROWS_AS(gnm(10, 46), std::invalid_argument);
+        CHECK_THROWS_AS(gnm(100000, 1LL << 30), std::invalid_argument);    // twice that overflows an int
+    }
+
+    SUBCASE("Grid with weights in range"){
+        options.minWeight = 3;
+        options.maxWeight = 9;
+        Graph g = grid(30, 40, options);
+        CHECK(g.getNumOfVertices() == 1200);
+        CHECK(g.getNumOfEdges() == 2 * (30 * 39 + 29 * 40));
+        CHECK(g.hasEdge(1, 2) == true);
+        CHECK(g.hasEdge(1, 41) == true);
+        CHECK(g.hasEdge(40, 41) == false);    // the end of a row
+        CHECK(g.getMinWeight() >= 3);
+        CHECK(g.getMaxWeight() <= 9);
+        BasicGraph<uint32_t, float> real = grid<BasicGraph<uint32_t, float>>(5, 5, options);
+        CHECK(real.getMinWeight() >= 3.0f);
+        CHECK(real.getMaxWeight() <= 9.0f);
+    }
+
+    SUBCASE("Random geometric graph"){
+        Graph g = randomGeometric(3000, 0.03, options);
+        Graph h = randomGeometric(3000, 0.03, parallel);
+        CHECK(g.getNumOfEdges() == h.getNumOfEdges());
+        double expected = 3000.0 * 2999 * 3.14159 * 0.03 * 0.03;    // entries, ignoring the border
+        CHECK(g.getNumOfEdges() > expected * 0.7);
+        CHECK(g.getNumOfEdges() < expected * 1.1);
+        CHECK(isSymmetric(g));
+        CHECK(g.getMaxWeight() <= 100);
+        CHECK(g.getMinWeight() >= 1);
+
+        UnweightedGraph u = randomGeometric<UnweightedGraph>(500, 0.1, options);
+        CHECK(u.getNumOfEdges() > 0);
     }
 }
 
@@ -636,9 +2603,60 @@ TEST_CASE("Prim algorithm tests"){
         
         CHECK_THROWS_AS(prim(g), std::invalid_argument);
     }
+
+    SUBCASE("Prim with the largest weight of the type"){
+        BasicGraph<uint32_t, uint8_t> g(3);
+        g.addEdge(1, 2, 1);
+        g.addEdge(2, 3, 255);
+        BasicGraph<uint32_t, uint8_t> mst = prim(g);
+        CHECK(mst.getNumOfEdges() == 2);
+        CHECK(mst.hasEdge(2, 3) == true);
+        CHECK(kruskal(g).getNumOfEdges() == mst.getNumOfEdges());
+    }
 }
 
 TEST_CASE("Kruskal algorithm tests"){
+    SUBCASE("Kruskal with 8 bit weights on many edges"){
+        // at most 256 distinct weights, so the sort is almost all ties
+        using GraphU8 = BasicGraph<uint32_t, uint8_t>;
+        GraphU8 g = grid<GraphU8>(300, 300);
+        GraphU8 mst = kruskal(g);
+        GraphU8 primTree = prim(g);
+        CHECK(mst.getNumOfEdges() == 300 * 300 - 1);
+        long long kruskalWeight = 0;
+        long long primWeight = 0;
+        for(uint32_t v = 1; v <= g.getNumOfVertices(); v++){
+            for(const Pair<uint32_t, uint8_t>& edge : mst.neighbors(v)) kruskalWeight += edge.second;
+            for(const Pair<uint32_t, uint8_t>& edge : primTree.neighbors(v)) primWeight += edge.second;
+        }
+        CHECK(kruskalWeight == primWeight);
+    }
+
+    SUBCASE("Kruskal on the pool"){
+        ThreadPool pool(4);
+        GeneratorOptions options;
+        options.seed = 21;
+        options.maxWeight = 10;     // many equal weights
+        Graph g = gnm<Graph>(20000, 60000, options);
+        Graph sequential = kruskal(g);
+        Graph parallel = parallelKruskal(g, pool);
+        std::stringstream first;
+        std::stringstream second;
+        writeEdgeList(sequential, first);
+        writeEdgeList(parallel, second);
+        CHECK(parallel.getNumOfEdges() == sequential.getNumOfEdges());
+        CHECK(first.str() == second.str());     // the same tree, not only the same weight
+
+        UnweightedGraph unweighted = grid<UnweightedGraph>(200, 200);
+        CHECK(parallelKruskal(unweighted, pool).getNumOfEdges() == 200 * 200 - 1);
+
+        Graph negative(2);
+        negative.addEdge(1, 2, -1);
+        CHECK_THROWS_AS(parallelKruskal(negative, pool), std::invalid_argument);
+        Graph empty(0);
+        CHECK_THROWS_AS(parallelKruskal(empty, pool), std::invalid_argument);
+    }
+
     SUBCASE("Kruskal on empty graph"){
         Graph g(0);
         CHECK_THROWS_AS(kruskal(g), std::invalid_argument);